@@ -10,103 +10,1524 @@
 #include <zephyr/device.h>
 #include <zephyr/input/input.h>
 #include <drivers/input_processor.h>
+#include <drivers/input_processor_batch.h>
+#include <drivers/input_processor_accumulator.h>
+#include <drivers/input_processor_absolute_to_relative.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/input_processor_idle_changed.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/devicetree.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_STATS)
+#include <zephyr/timing/timing.h>
+#endif
+
+#define RUNTIME_PARAMS IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_ABSOLUTE_TO_RELATIVE_RUNTIME_PARAMS)
+
+#if RUNTIME_PARAMS && IS_ENABLED(CONFIG_SETTINGS)
+#include <zephyr/settings/settings.h>
+#endif
 
 LOG_MODULE_REGISTER(absolute_to_relative, CONFIG_ZMK_LOG_LEVEL);
 
-/* Sentinel values for uninitialized coordinates */
-#define COORD_UNINITIALIZED UINT16_MAX
-#define COORD_INVALID_ZERO  0xFFF
+ZMK_EVENT_IMPL(zmk_input_processor_idle_changed);
+
+/* Event code of suppressed events */
+#define COORD_INVALID_ZERO 0xFFF
+
+/* Smoothing filters, in devicetree `filter` enum order */
+enum absolute_to_relative_filter {
+    FILTER_NONE,
+    FILTER_AVERAGE,
+    FILTER_MOVING_AVERAGE,
+    FILTER_ONE_EURO,
+};
+
+/* Fixed-point format of the filter state (Q8) */
+#define FILTER_FRAC_BITS 8
+#define FILTER_ONE      (1 << FILTER_FRAC_BITS)
+#define FILTER_MAX_TAPS 8
+/*
+ * Saturation of the Q8 intermediates between stages: 2^20 counts, far beyond the int16
+ * output, so only the final step limits the motion. Keeps the prediction sums in int32.
+ */
+#define FILTER_VALUE_MAX ((1 << 28) - 1)
+/* One-Euro speed estimate low-pass: alpha = 1/4 */
+#define ONE_EURO_SPEED_SHIFT 2
+/* With beta limited to ONE_EURO_BETA_MAX, keeps (speed * beta) and (diff * alpha) in int32 */
+#define ONE_EURO_SPEED_MAX (1 << 16)
+#define ONE_EURO_BETA_MAX  ((1 << 15) - 1)
+#define ONE_EURO_DIFF_MAX  ((1 << 23) - 1)
+
+/* Acceleration curve: up to 8 <speed gain> points, gain in 1/256 units (Q8) */
+#define ACCEL_MAX_POINTS ZIP_ABSOLUTE_TO_RELATIVE_ACCEL_MAX_POINTS
+#define ACCEL_GAIN_MAX   4095
+/* Keeps the interpolation product inside int32 */
+#define ACCEL_SPEED_MAX  ((1 << 19) - 1)
+
+/* Interval normalization scale limits (Q8): 1/4x .. 4x */
+#define NORMALIZE_SCALE_MIN (FILTER_ONE >> 2)
+#define NORMALIZE_SCALE_MAX (FILTER_ONE << 2)
+
+/* Prediction: velocity over the last 4 output deltas, look-ahead up to 8 samples (Q8) */
+#define PREDICT_SAMPLES       4
+#define PREDICT_LOOKAHEAD_MAX (8 << FILTER_FRAC_BITS)
+
+/* Handler cycle histogram: bucket i counts calls taking [2^(i-1), 2^i) cycles */
+#define STATS_HIST_BUCKETS 16
+
+/* Transform scale limits (Q8): 1/256x .. 4x */
+#define TRANSFORM_SCALE_MAX (FILTER_ONE << 2)
+
+/* Edge motion tick when report-interval-ms is 0 */
+#define EDGE_MOTION_PERIOD_MS 10
+
+/* Longest wait of a runtime parameter change for the last reader of the copy it rewrites */
+#define PARAMS_GRACE_MS 100
+
+#define MAX_CONTACTS   CONFIG_ZMK_INPUT_PROCESSOR_ABSOLUTE_TO_RELATIVE_MAX_CONTACTS
+#define NO_CONTACT     UINT8_MAX
+
+/* Generated event pool; 0 reports straight to the input queue */
+#define EMIT_POOL_SIZE CONFIG_ZMK_INPUT_PROCESSOR_ABSOLUTE_TO_RELATIVE_EMIT_POOL_SIZE
+/* Drain retry delay while the input queue is full */
+#define EMIT_RETRY_MS 1
+
+/* Pool back-pressure policies, in devicetree `emit-policy` enum order */
+enum emit_policy {
+    EMIT_DROP_OLDEST,
+    EMIT_MERGE,
+    EMIT_BLOCK,
+};
+
+/*
+ * Devicetree-wide folding of per-instance settings. INST_ENABLED(config, prop) is a
+ * compile-time constant when every instance agrees on whether `prop` is set, so the
+ * config load and the branch it guards are dropped; mixed builds read the config.
+ */
+#define INST_PROP_SET(n, prop) +(DT_INST_PROP_OR(n, prop, 0) != 0)
+#define INST_PROP_SET_COUNT(prop)                                                                  \
+    (0 DT_INST_FOREACH_STATUS_OKAY_VARGS(INST_PROP_SET, prop))
+#define INST_COUNT DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT)
+#define INST_ENABLED(config, prop)                                                                 \
+    (INST_PROP_SET_COUNT(prop) == 0            ? false                                             \
+     : INST_PROP_SET_COUNT(prop) == INST_COUNT ? true                                              \
+                                               : ((config)->prop != 0))
+
+/* Runtime-tunable parameters can change after boot, so they are never folded */
+#if RUNTIME_PARAMS
+#define TUNABLE_ENABLED(config, prop) ((config)->prop != 0)
+#else
+#define TUNABLE_ENABLED(config, prop) INST_ENABLED(config, prop)
+#endif
 
 struct absolute_to_relative_config {
     bool suppress_btn_touch;
     bool suppress_btn0;
+    bool frame_mode;
+    bool scroll_mode;
+    uint8_t filter;
+    uint8_t filter_taps_shift;
+    uint16_t filter_min_alpha;
+    uint16_t filter_beta;
+    uint32_t report_interval_ms;
+    /* Adaptive coalescing: interval at report_adaptive_speed counts per sample */
+    uint16_t report_interval_max_ms;
+    uint16_t report_adaptive_speed;
+    uint16_t scroll_divisor;
+    uint32_t scroll_interval_ms;
+    /* Flattened <speed gain> pairs, speed ascending in counts/s */
+    const uint32_t *accel_curve;
+    uint8_t accel_points;
+    uint32_t nominal_period_ms;
+    uint32_t stale_timeout_ms;
+    uint16_t deadzone;
+    uint8_t deadzone_rest_samples;
+    uint32_t idle_timeout_ms;
+    /* Sensor ABS ranges, used by edge motion and to bound positions; min == max if unset */
+    int32_t abs_x_min, abs_x_max;
+    int32_t abs_y_min, abs_y_max;
+    uint16_t edge_motion_border;
+    uint16_t edge_motion_speed;
+    /* Sensor-to-output transform, folded into axis maps at init */
+    bool swap_xy;
+    bool invert_x;
+    bool invert_y;
+    uint8_t rotation; /* 90 degree clockwise steps */
+    uint16_t scale_x, scale_y; /* Q8 */
+    uint8_t inertia_decay;      /* Q8 velocity kept per report tick */
+    uint16_t inertia_min_speed; /* Q8 counts per tick */
+    uint16_t tap_timeout_ms;
+    uint16_t tap_max_travel;
+    uint16_t tap_drag_timeout_ms;
+    uint16_t palm_pressure;    /* ABS_PRESSURE that rejects the touch session */
+    uint16_t palm_touch_major; /* ABS_MT_TOUCH_MAJOR that rejects the touch session */
+    uint16_t max_jump;         /* Largest raw single-sample delta, in counts */
+    bool fast_start;          /* First delta of a touch seeds the filter */
+    bool pass_first_position; /* Touch-down position is forwarded as ABS */
+    uint16_t prediction_ms;   /* Linear extrapolation look-ahead */
+    uint8_t emit_policy;
+};
+
+/* Per-axis smoothing state (moving-average and One-Euro filters) */
+struct axis_filter {
+    int16_t history[FILTER_MAX_TAPS];
+    int32_t sum;
+    uint8_t index;
+    int32_t filtered;  /* Q8 */
+    int32_t speed;     /* Q8 */
+    int32_t remainder; /* Q8 sub-count carried into the next report */
+    uint32_t timestamp; /* Last sample time in ticks */
+    int32_t gate_held;   /* Deadzone: output held back while at rest */
+    int32_t gate_window; /* Deadzone: net output over the current sample window */
+    int32_t predict_ring[PREDICT_SAMPLES]; /* Prediction: last Q8 output deltas */
+    int32_t predict_sum;
+    int32_t predicted; /* Prediction: Q8 look-ahead offset already emitted */
+    uint8_t predict_index;
+};
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_STATS)
+/* Hot-path counters (CONFIG_ZMK_INPUT_PROCESSOR_STATS) */
+struct absolute_to_relative_stats {
+    uint32_t events_in;
+    uint32_t suppressed;
+    uint32_t emitted; /* Events reported from the processor device */
+    uint32_t touch_sessions;
+    uint32_t first_sample_drops;
+    uint32_t deadzone_drops;
+    uint32_t palm_drops; /* Position samples of rejected touch sessions */
+    uint32_t jump_drops;
+    uint32_t emit_drops;  /* Generated events dropped by the full pool */
+    uint32_t emit_merges; /* Generated events merged into a pending one */
+    uint32_t cycles_hist[STATS_HIST_BUCKETS];
+    uint64_t cycles_total;
+    int64_t since_ms; /* Uptime of the last reset */
+};
+
+#define STATS_INC(data, field)    ((data)->stats.field++)
+#define STATS_ADD(data, field, n) ((data)->stats.field += (n))
+#else
+#define STATS_INC(data, field)
+#define STATS_ADD(data, field, n)
+#endif
+
+/* Output axis and Q8 gain of one sensor axis, from the transform matrix */
+struct axis_map {
+    uint16_t rel_code;
+    int16_t gain;
+};
+
+/* Sensor axes, indexing the per-axis state */
+enum axis {
+    AXIS_X,
+    AXIS_Y,
+    AXIS_COUNT,
+};
+
+#define AXES_ALL BIT_MASK(AXIS_COUNT)
+
+/* Per-axis conversion state */
+struct axis_state {
+    int32_t previous;       /* Last position, valid once the axis' uninitialized bit is clear */
+    int16_t previous_delta; /* Last raw delta */
+    struct axis_filter filter;
+    struct axis_map map;
+};
+
+/* Sensor axis of each position code; only the single-touch and MT position codes are looked up */
+static const uint8_t code_axis[] = {
+    [INPUT_ABS_X] = AXIS_X,
+    [INPUT_ABS_Y] = AXIS_Y,
+    [INPUT_ABS_MT_POSITION_X] = AXIS_X,
+    [INPUT_ABS_MT_POSITION_Y] = AXIS_Y,
+};
+
+/* Outcome of converting one axis sample */
+enum axis_result {
+    AXIS_CONVERTED, /* Rewritten as relative motion */
+    AXIS_DROPPED,   /* Suppressed: first position or rejected jump */
+    AXIS_PASSED,    /* Touch-down position forwarded unchanged */
+};
+
+/* Tap gesture state */
+enum tap_state {
+    TAP_IDLE,
+    TAP_PENDING,  /* Tap clicked, BTN_0 held for the drag window */
+    TAP_DRAGGING, /* Touch landed in the drag window, BTN_0 held until it lifts */
+};
+
+#if EMIT_POOL_SIZE > 0
+/* One generated event waiting for the input queue */
+struct emit_entry {
+    int32_t value;
+    uint16_t code;
+    uint8_t type;
+    bool sync;
+};
+
+/* Ring of generated events, oldest at head, drained by its own work item */
+struct emit_pool {
+    struct k_spinlock lock;
+    struct emit_entry entries[EMIT_POOL_SIZE];
+    uint8_t head;
+    uint8_t count;
+    bool in_flight; /* A drain took the head event and is still reporting it */
+    struct k_work_delayable work;
+};
+#endif
+
+/* Multi-touch contact state, indexed by ABS_MT_SLOT */
+struct contact {
+    int32_t x, y;
+    uint8_t known; /* Bit per axis with a position since the contact landed */
+    bool active;
 };
 
 struct absolute_to_relative_data {
-    uint16_t previous_x, previous_y;
-    int16_t previous_dx, previous_dy;
+    struct axis_state axes[AXIS_COUNT];
+    uint8_t uninitialized; /* Bit per axis with no position since touch-down or a stale reset */
+    uint8_t warming;       /* Bit per axis whose first delta has not been filtered yet */
     bool touching;
+    struct contact contacts[MAX_CONTACTS];
+    uint8_t slot;         /* Current ABS_MT_SLOT, MAX_CONTACTS if out of range */
+    uint8_t primary_slot; /* Contact driving pointer motion, NO_CONTACT if none */
+    uint8_t contact_count;
+    /* Two-finger scroll: summed Q8 contact deltas (2x the centroid delta) not yet reported */
+    struct zip_accumulator scroll;
+    /* Motion since the last coalesced report or sensor frame; its timer is the report timer */
+    struct zip_accumulator motion;
+    /* Adaptive coalescing: running average of the raw speed, in counts per sample */
+    uint16_t report_speed;
+    /* Protects the inertia state */
+    struct k_spinlock lock;
+    /* nominal_period_ms / stale_timeout_ms converted at init */
+    uint32_t nominal_period_ticks, stale_timeout_ticks;
+    uint32_t prediction_ticks;
+    /* Inertia: output motion since the last tick, per-tick velocity and glide remainder (Q8) */
+    int32_t inertia_acc_x, inertia_acc_y;
+    int32_t inertia_velocity_x, inertia_velocity_y;
+    int32_t inertia_remainder_x, inertia_remainder_y;
+    /* Tap detection: session start (ms), raw travel in counts, more than one contact seen */
+    uint32_t tap_start_ms;
+    uint32_t tap_travel;
+    bool tap_multi;
+    atomic_t tap_state;
+    struct k_work_delayable tap_work;
+    /* Palm rejection: the current touch session is dropped until it ends */
+    bool palm;
+    /* Deadzone gate: motion has left the deadzone, samples in the current window */
+    bool moving;
+    uint8_t gate_samples;
+    /* Idle detection: raised after idle_timeout_ms without a touch, cleared on touch */
+    atomic_t idle;
+    struct k_work_delayable idle_work;
+#if EMIT_POOL_SIZE > 0
+    struct emit_pool pool;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_STATS)
+    struct absolute_to_relative_stats stats;
+#endif
+#if RUNTIME_PARAMS
+    /* Double-buffered config copies with the tunable fields; the active one is swapped in */
+    struct absolute_to_relative_config runtime[2];
+    uint32_t runtime_curve[2][2 * ACCEL_MAX_POINTS];
+    atomic_ptr_t active;
+    atomic_t readers[2]; /* Handlers and timers holding each copy */
+#if IS_ENABLED(CONFIG_SETTINGS)
+    struct k_work_delayable save_work;
+#endif
+#endif
     const struct device *dev;
 };
 
+/**
+ * Config seen by the event path and timers: the runtime copy when parameters are tunable.
+ * Every call is paired with active_config_put(); until then params_apply() does not
+ * rewrite the copy. The reader is counted before the copy is confirmed active, so a
+ * writer either sees the count or the reader sees the swap and moves to the new copy.
+ */
+static inline const struct absolute_to_relative_config *
+active_config_get(const struct device *dev) {
+#if RUNTIME_PARAMS
+    struct absolute_to_relative_data *data = dev->data;
+
+    for (;;) {
+        const struct absolute_to_relative_config *config = atomic_ptr_get(&data->active);
+        atomic_t *readers = &data->readers[config - data->runtime];
+
+        atomic_inc(readers);
+        if (atomic_ptr_get(&data->active) == config) {
+            return config;
+        }
+        atomic_dec(readers);
+    }
+#else
+    return dev->config;
+#endif
+}
+
+static inline void active_config_put(const struct device *dev,
+                                     const struct absolute_to_relative_config *config) {
+#if RUNTIME_PARAMS
+    struct absolute_to_relative_data *data = dev->data;
+
+    atomic_dec(&data->readers[config - data->runtime]);
+#else
+    ARG_UNUSED(dev);
+    ARG_UNUSED(config);
+#endif
+}
+
 /**
  * Initialize coordinates when touch starts
  */
 static inline void touch_init(struct absolute_to_relative_data *data) {
-    data->previous_x = COORD_UNINITIALIZED;
-    data->previous_y = COORD_UNINITIALIZED;
-    data->previous_dx = 0;
-    data->previous_dy = 0;
+    for (int axis = 0; axis < AXIS_COUNT; axis++) {
+        data->axes[axis].previous_delta = 0;
+        memset(&data->axes[axis].filter, 0, sizeof(data->axes[axis].filter));
+    }
+    data->uninitialized = AXES_ALL;
+    data->report_speed = 0;
+    data->moving = false;
+    data->gate_samples = 0;
     if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
         LOG_DBG("Touch started - coordinates initialized");
     }
 }
 
+/**
+ * N-tap moving average (N = 2, 4 or 8) over a running sum, Q8 result
+ */
+static inline int32_t filter_moving_average(int16_t delta, struct axis_filter *filter,
+                                            const struct absolute_to_relative_config *config) {
+    filter->sum += delta - filter->history[filter->index];
+    filter->history[filter->index] = delta;
+    filter->index = (filter->index + 1) & BIT_MASK(config->filter_taps_shift);
+
+    return (filter->sum << FILTER_FRAC_BITS) >> config->filter_taps_shift;
+}
+
+/**
+ * Adaptive One-Euro style low-pass in Q8 fixed point.
+ * The cutoff (alpha) rises from filter_min_alpha with the smoothed speed, scaled by
+ * filter_beta, so slow motion is smoothed heavily while fast flicks pass with little lag.
+ */
+static inline int32_t filter_one_euro(int16_t delta, struct axis_filter *filter,
+                                      const struct absolute_to_relative_config *config) {
+    const int32_t sample = (int32_t)delta << FILTER_FRAC_BITS;
+    const int32_t magnitude = (sample < 0) ? -sample : sample;
+
+    filter->speed += (magnitude - filter->speed) >> ONE_EURO_SPEED_SHIFT;
+
+    int32_t alpha = config->filter_min_alpha +
+                    ((MIN(filter->speed, ONE_EURO_SPEED_MAX) * config->filter_beta) >>
+                     FILTER_FRAC_BITS);
+    alpha = MIN(alpha, FILTER_ONE);
+
+    const int32_t diff = CLAMP(sample - filter->filtered, -ONE_EURO_DIFF_MAX, ONE_EURO_DIFF_MAX);
+    filter->filtered += (diff * alpha) >> FILTER_FRAC_BITS;
+
+    return filter->filtered;
+}
+
+/**
+ * Apply the configured smoothing filter to a raw axis delta, Q8 result
+ */
+static inline int32_t filter_delta(int16_t delta, int16_t previous_delta, struct axis_filter *filter,
+                                   const struct absolute_to_relative_config *config) {
+    switch (config->filter) {
+    case FILTER_NONE:
+        return (int32_t)delta << FILTER_FRAC_BITS;
+    case FILTER_MOVING_AVERAGE:
+        return filter_moving_average(delta, filter, config);
+    case FILTER_ONE_EURO:
+        return filter_one_euro(delta, filter, config);
+    case FILTER_AVERAGE:
+    default:
+        return ((int32_t)delta + previous_delta) << (FILTER_FRAC_BITS - 1);
+    }
+}
+
+/**
+ * Seed the smoothing state as if @p delta had been the motion so far (fast start)
+ */
+static inline void filter_seed(int16_t delta, struct axis_state *state,
+                               const struct absolute_to_relative_config *config) {
+    struct axis_filter *filter = &state->filter;
+
+    state->previous_delta = delta;
+    switch (config->filter) {
+    case FILTER_MOVING_AVERAGE:
+        for (uint8_t i = 0; i < BIT(config->filter_taps_shift); i++) {
+            filter->history[i] = delta;
+        }
+        filter->sum = (int32_t)delta << config->filter_taps_shift;
+        break;
+    case FILTER_ONE_EURO:
+        filter->filtered = (int32_t)delta << FILTER_FRAC_BITS;
+        filter->speed = abs(filter->filtered);
+        break;
+    default:
+        break;
+    }
+}
+
+
+/**
+ * Multiply a Q8 value by a Q8 gain in 64-bit, saturated to the intermediate range
+ */
+static inline int32_t filter_scale(int32_t value, int32_t gain) {
+    return CLAMP(((int64_t)value * gain) >> FILTER_FRAC_BITS, -FILTER_VALUE_MAX,
+                 FILTER_VALUE_MAX);
+}
+
+/**
+ * Piecewise-linear interpolation of the acceleration gain (Q8) at @p speed (counts/s).
+ * Speeds outside the curve use the gain of the nearest end point.
+ */
+static inline int32_t accel_gain(uint32_t speed, const struct absolute_to_relative_config *config) {
+    const uint32_t *curve = config->accel_curve;
+
+    if (speed <= curve[0]) {
+        return curve[1];
+    }
+
+    for (uint8_t i = 1; i < config->accel_points; i++) {
+        const uint32_t speed_hi = curve[2 * i];
+        if (speed < speed_hi) {
+            const uint32_t speed_lo = curve[2 * i - 2];
+            const int32_t gain_lo = curve[2 * i - 1];
+            const int32_t gain_hi = curve[2 * i + 1];
+
+            return gain_lo + (gain_hi - gain_lo) * (int32_t)(speed - speed_lo) /
+                                 (int32_t)(speed_hi - speed_lo);
+        }
+    }
+
+    return curve[2 * config->accel_points - 1];
+}
+
+/**
+ * Scale a smoothed Q8 delta by the acceleration curve.
+ * Speed is the approximate X/Y magnitude (max + min / 2) of the latest deltas over the
+ * @p elapsed ticks since this axis' previous sample.
+ */
+static inline int32_t accelerate(int32_t value, int16_t delta, int16_t other_delta,
+                                 uint32_t elapsed, const struct absolute_to_relative_config *config) {
+    const uint32_t a = (delta < 0) ? -delta : delta;
+    const uint32_t b = (other_delta < 0) ? -other_delta : other_delta;
+    const uint32_t magnitude = MAX(a, b) + (MIN(a, b) >> 1);
+    const uint32_t speed =
+        MIN(magnitude * CONFIG_SYS_CLOCK_TICKS_PER_SEC / elapsed, ACCEL_SPEED_MAX);
+
+    return filter_scale(value, CLAMP(accel_gain(speed, config), 0, ACCEL_GAIN_MAX));
+}
+
+/**
+ * Scale a smoothed Q8 delta to the motion of one nominal sample period
+ */
+static inline int32_t normalize_interval(int32_t value, uint32_t elapsed,
+                                         const struct absolute_to_relative_data *data) {
+    const uint32_t ratio = (data->nominal_period_ticks << FILTER_FRAC_BITS) / elapsed;
+    const int32_t scale = CLAMP(ratio, (uint32_t)NORMALIZE_SCALE_MIN, (uint32_t)NORMALIZE_SCALE_MAX);
+
+    return filter_scale(value, scale);
+}
+
+/**
+ * Linear extrapolation of a Q8 output delta, prediction_ms ahead.
+ * Velocity is the mean of the last PREDICT_SAMPLES deltas and acceleration the change
+ * across them; the look-ahead offset they give is kept between zero and twice the
+ * velocity term, so braking cannot reverse it. Only the change of the offset is added
+ * to the delta, so once the finger slows the offset shrinks and pays back the lead.
+ */
+static inline int32_t predict(int32_t value, uint32_t elapsed, struct axis_filter *filter,
+                              const struct absolute_to_relative_data *data) {
+    const int32_t oldest = filter->predict_ring[filter->predict_index];
+
+    filter->predict_sum += value - oldest;
+    filter->predict_ring[filter->predict_index] = value;
+    filter->predict_index = (filter->predict_index + 1) & (PREDICT_SAMPLES - 1);
+
+    /* Look-ahead in samples (Q8) at the measured sample interval */
+    const int64_t ahead =
+        MIN(((uint64_t)data->prediction_ticks << FILTER_FRAC_BITS) / elapsed,
+            PREDICT_LOOKAHEAD_MAX);
+    const int64_t velocity = filter->predict_sum / PREDICT_SAMPLES;
+    const int64_t accel = (value - oldest) / PREDICT_SAMPLES;
+    const int64_t lead = (velocity * ahead) >> FILTER_FRAC_BITS;
+    int64_t offset = lead + ((accel * ahead * ahead) >> (2 * FILTER_FRAC_BITS + 1));
+
+    offset = CLAMP(offset, -FILTER_VALUE_MAX, FILTER_VALUE_MAX);
+    offset = (lead >= 0) ? CLAMP(offset, 0, 2 * lead) : CLAMP(offset, 2 * lead, 0);
+
+    const int32_t correction = (int32_t)offset - filter->predicted;
+
+    filter->predicted = offset;
+    return value + correction;
+}
+
+/**
+ * Reset one axis to its touch-down state. An outstanding prediction lead is kept, so the
+ * next converted sample still pays it back.
+ */
+static inline void axis_reset(struct absolute_to_relative_data *data, enum axis axis) {
+    struct axis_filter *filter = &data->axes[axis].filter;
+    const int32_t predicted = filter->predicted;
+
+    data->axes[axis].previous_delta = 0;
+    memset(filter, 0, sizeof(*filter));
+    filter->predicted = predicted;
+    data->uninitialized |= BIT(axis);
+}
+
+/**
+ * Sample timestamps are only needed by the time-based stages
+ */
+static inline bool timed_stages(const struct absolute_to_relative_config *config) {
+    return config->accel_points > 0 || INST_ENABLED(config, nominal_period_ms) ||
+           INST_ENABLED(config, stale_timeout_ms) || INST_ENABLED(config, prediction_ms);
+}
+
+/**
+ * Map a Q8 sensor-space pair to output axes through the folded transform
+ */
+static inline void transform_pair(const struct absolute_to_relative_data *data, int32_t x,
+                                  int32_t y, int32_t *out_x, int32_t *out_y) {
+    const int32_t in[AXIS_COUNT] = {x, y};
+    int32_t out[2] = {0, 0};
+
+    for (int axis = 0; axis < AXIS_COUNT; axis++) {
+        const struct axis_map *map = &data->axes[axis].map;
+
+        out[map->rel_code == INPUT_REL_Y] += filter_scale(in[axis], map->gain);
+    }
+    *out_x = out[0];
+    *out_y = out[1];
+}
+
+/**
+ * Bound a sensor position to the abs range of its axis, if one is set
+ */
+static inline int32_t axis_position(int32_t value, enum axis axis,
+                                    const struct absolute_to_relative_config *config) {
+    const int32_t min = (axis == AXIS_X) ? config->abs_x_min : config->abs_y_min;
+    const int32_t max = (axis == AXIS_X) ? config->abs_x_max : config->abs_y_max;
+
+    return (min < max) ? CLAMP(value, min, max) : value;
+}
+
+/**
+ * Delta between two positions over the full int32 range, saturated to the int16 REL domain
+ */
+static inline int16_t position_delta(int32_t value, int32_t previous) {
+    return CLAMP((int64_t)value - previous, INT16_MIN, INT16_MAX);
+}
+
 /**
  * Process absolute-to-relative conversion for a single axis
- * Returns true if first position (should suppress event), false if normal motion
  */
-static inline bool process_axis(struct input_event *event, uint16_t *previous_pos, int16_t *previous_delta,
-                         uint16_t rel_code) {
-    const uint16_t value = event->value;
+static inline enum axis_result process_axis(struct input_event *event, enum axis axis,
+                                            struct absolute_to_relative_data *data,
+                                            const struct absolute_to_relative_config *config) {
+    const int32_t value = axis_position(event->value, axis, config);
+    struct axis_state *state = &data->axes[axis];
+    struct axis_filter *filter = &state->filter;
+    const struct axis_map *map = &state->map;
+    /* Acceleration uses the motion magnitude across both axes */
+    const int16_t other_delta = data->axes[axis ^ 1].previous_delta;
+    uint32_t elapsed = 0;
 
-    uint16_t prev = *previous_pos;
-    if (prev == COORD_UNINITIALIZED) {
-        /* First report on this axis - store position and suppress output */
-        *previous_pos = value;
-        *previous_delta = 0;
+    if (timed_stages(config)) {
+        const uint32_t now = (uint32_t)k_uptime_ticks();
+        elapsed = MAX(now - filter->timestamp, 1);
+
+        /* A long gap restarts the axis like a new touch instead of producing one big jump */
+        if (INST_ENABLED(config, stale_timeout_ms) && !(data->uninitialized & BIT(axis)) &&
+            elapsed > data->stale_timeout_ticks) {
+            if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
+                LOG_DBG("Stale %c sample after %u ticks - history reset", "XY"[axis], elapsed);
+            }
+            axis_reset(data, axis);
+        }
+        filter->timestamp = now;
+    }
+
+    if (data->uninitialized & BIT(axis)) {
+        /* First report on this axis - store position, no relative output yet */
+        state->previous = value;
+        state->previous_delta = 0;
+        data->uninitialized &= ~BIT(axis);
+        data->warming |= BIT(axis);
         if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
-            LOG_DBG("Initial %s position: %u (suppressed)", (rel_code == INPUT_REL_X) ? "X" : "Y", value);
+            LOG_DBG("Initial %c position: %d", "XY"[axis], value);
+        }
+
+        /* Absolute-mode consumers get the touch-down position at once */
+        if (INST_ENABLED(config, pass_first_position)) {
+            return AXIS_PASSED;
         }
 
         /* Mark event as invalid for clarity */
+        STATS_INC(data, first_sample_drops);
+        event->code = COORD_INVALID_ZERO;
+        event->sync = false;
+
+        return AXIS_DROPPED;
+    }
+
+    /* Calculate delta and apply smoothing */
+    const int16_t delta = position_delta(value, state->previous);
+
+    /* A single-sample jump beyond max_jump is a glitch: continue from the new position */
+    if (INST_ENABLED(config, max_jump) && abs(delta) > config->max_jump) {
+        STATS_INC(data, jump_drops);
+        if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
+            LOG_DBG("%c jump of %d rejected", "XY"[axis], delta);
+        }
+        state->previous = value;
+        state->previous_delta = 0;
+        event->code = COORD_INVALID_ZERO;
+        event->sync = false;
+        return AXIS_DROPPED;
+    }
+
+    /* Fast start: the first delta seeds the filter, so smoothing has no warm-up */
+    if (INST_ENABLED(config, fast_start) && (data->warming & BIT(axis))) {
+        filter_seed(delta, state, config);
+    }
+    data->warming &= ~BIT(axis);
+
+    int32_t smoothed = filter_delta(delta, state->previous_delta, filter, config);
+
+    /* Scale and orientation: one multiply by this axis' column of the transform matrix */
+    smoothed = filter_scale(smoothed, map->gain);
+
+    if (INST_ENABLED(config, nominal_period_ms)) {
+        smoothed = normalize_interval(smoothed, elapsed, data);
+    }
+
+    /* Acceleration runs in the same pass, on the Q8 value before rounding */
+    if (config->accel_points > 0) {
+        smoothed = accelerate(smoothed, delta, other_delta, elapsed, config);
+    }
+
+    if (INST_ENABLED(config, prediction_ms)) {
+        smoothed = predict(smoothed, elapsed, filter, data);
+    }
+
+    /* Round to whole counts, carrying the fraction into the next report */
+    const int32_t counts = zip_carry_round(smoothed, &filter->remainder, FILTER_FRAC_BITS);
+    const int16_t smooth_delta = CLAMP(counts, INT16_MIN, INT16_MAX);
+
+    if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
+        LOG_DBG("%c: %d -> rel_%s: %d (raw_delta: %d, smoothed: %d)", "XY"[axis], value,
+                (map->rel_code == INPUT_REL_X) ? "x" : "y", smooth_delta, delta, smooth_delta);
+    }
+
+    /* Update event and state */
+    event->type = INPUT_EV_REL;
+    event->code = map->rel_code;
+    event->value = smooth_delta;
+    state->previous_delta = delta;
+    state->previous = value;
+
+    return AXIS_CONVERTED;
+}
+
+/**
+ * Deadzone/hysteresis gate on one converted axis event.
+ * At rest, output is held until the net motion on an axis leaves the deadzone; it is then
+ * released in full, so slow deliberate movement only starts later and is never lost. Held
+ * motion that stays inside the deadzone, on the other axis when the gate opens or on both
+ * for a whole window of deadzone_rest_samples samples, is discarded as jitter. While moving, everything passes; a window whose net
+ * motion on both axes stays inside the deadzone returns the gate to rest.
+ * Returns true if the event is held back.
+ */
+static bool deadzone_gate(struct input_event *event, struct axis_filter *filter,
+                          struct absolute_to_relative_data *data,
+                          const struct absolute_to_relative_config *config) {
+    const int32_t deadzone = config->deadzone;
+    bool held = false;
+
+    if (!data->moving) {
+        filter->gate_held += event->value;
+        held = abs(filter->gate_held) <= deadzone;
+        if (!held) {
+            if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
+                LOG_DBG("Left deadzone, releasing %d", filter->gate_held);
+            }
+            event->value = CLAMP(filter->gate_held, INT16_MIN, INT16_MAX);
+            data->moving = true;
+            data->gate_samples = 0;
+            /* What the other axis held is still inside the deadzone; drop it so it cannot
+             * return as a stale burst at the next rest */
+            for (int axis = 0; axis < AXIS_COUNT; axis++) {
+                data->axes[axis].filter.gate_held = 0;
+                data->axes[axis].filter.gate_window = 0;
+            }
+        }
+    }
+
+    if (data->moving) {
+        filter->gate_window += event->value;
+    }
+
+    if (++data->gate_samples >= config->deadzone_rest_samples) {
+        bool settled = data->moving;
+
+        for (int axis = 0; axis < AXIS_COUNT; axis++) {
+            struct axis_filter *axis_filter = &data->axes[axis].filter;
+
+            /* Jitter that never left the deadzone is dropped */
+            if (!data->moving) {
+                axis_filter->gate_held = 0;
+            }
+            settled &= abs(axis_filter->gate_window) <= deadzone;
+            axis_filter->gate_window = 0;
+        }
+        if (settled) {
+            data->moving = false;
+            if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
+                LOG_DBG("Motion settled - deadzone gate at rest");
+            }
+        }
+        data->gate_samples = 0;
+    }
+
+    if (held) {
         event->code = COORD_INVALID_ZERO;
         event->sync = false;
+    }
+    return held;
+}
+
+#if EMIT_POOL_SIZE > 0
+static inline struct emit_entry *pool_entry(struct emit_pool *pool, uint8_t i) {
+    return &pool->entries[(pool->head + i) % EMIT_POOL_SIZE];
+}
+
+/**
+ * Report pooled events oldest first until the pool is empty or the input queue has no
+ * room within @p timeout; a refused event goes back to the front and the drain is retried.
+ * Only one drain reports at a time, and an event stays marked in flight until it has been
+ * reported, so neither another drain nor the direct path of emit_event() can overtake it.
+ */
+static void pool_drain(struct absolute_to_relative_data *data, k_timeout_t timeout) {
+    struct emit_pool *pool = &data->pool;
+
+    for (;;) {
+        k_spinlock_key_t key = k_spin_lock(&pool->lock);
+        /* A drain in flight keeps going until the pool is empty */
+        if (pool->count == 0 || pool->in_flight) {
+            k_spin_unlock(&pool->lock, key);
+            return;
+        }
+        const struct emit_entry entry = *pool_entry(pool, 0);
+        pool->head = (pool->head + 1) % EMIT_POOL_SIZE;
+        pool->count--;
+        pool->in_flight = true;
+        k_spin_unlock(&pool->lock, key);
+
+        const int ret =
+            input_report(data->dev, entry.type, entry.code, entry.value, entry.sync, timeout);
+
+        key = k_spin_lock(&pool->lock);
+        pool->in_flight = false;
+        if (ret == 0) {
+            k_spin_unlock(&pool->lock, key);
+            STATS_INC(data, emitted);
+            continue;
+        }
+
+        if (pool->count < EMIT_POOL_SIZE) {
+            pool->head = (pool->head + EMIT_POOL_SIZE - 1) % EMIT_POOL_SIZE;
+            pool->entries[pool->head] = entry;
+            pool->count++;
+        } else {
+            STATS_INC(data, emit_drops);
+        }
+        k_spin_unlock(&pool->lock, key);
+        k_work_schedule(&pool->work, K_MSEC(EMIT_RETRY_MS));
+        return;
+    }
+}
+
+/**
+ * Merge policy: add a relative value to the newest pending event with the same code.
+ * Returns false if there is none (buttons are never merged).
+ */
+static bool pool_merge(struct emit_pool *pool, uint8_t type, uint16_t code, int32_t value,
+                       bool sync) {
+    if (type != INPUT_EV_REL) {
+        return false;
+    }
+
+    for (int i = pool->count - 1; i >= 0; i--) {
+        struct emit_entry *entry = pool_entry(pool, i);
+
+        if (entry->type == INPUT_EV_REL && entry->code == code) {
+            entry->value = CLAMP(entry->value + value, INT16_MIN, INT16_MAX);
+            pool_entry(pool, pool->count - 1)->sync |= sync;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Drop the oldest pending relative event (the oldest event if there are only buttons,
+ * so a release is not lost behind them). Its sync flag moves to the event before it.
+ */
+static void pool_drop_oldest(struct emit_pool *pool) {
+    uint8_t drop = 0;
+
+    for (uint8_t i = 0; i < pool->count; i++) {
+        if (pool_entry(pool, i)->type == INPUT_EV_REL) {
+            drop = i;
+            break;
+        }
+    }
 
-        return true; /* Signal to suppress this event */
+    if (drop > 0) {
+        pool_entry(pool, drop - 1)->sync |= pool_entry(pool, drop)->sync;
     }
+    for (uint8_t i = drop; i + 1 < pool->count; i++) {
+        *pool_entry(pool, i) = *pool_entry(pool, i + 1);
+    }
+    pool->count--;
+}
+
+/**
+ * Pool drain work
+ */
+static void emit_work_handler(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct absolute_to_relative_data *data =
+        CONTAINER_OF(dwork, struct absolute_to_relative_data, pool.work);
+    const struct absolute_to_relative_config *config = data->dev->config;
+
+    pool_drain(data, config->emit_policy == EMIT_BLOCK ? K_FOREVER : K_NO_WAIT);
+}
+#endif
+
+/**
+ * Emit one generated event from the processor device.
+ * With the event pool, an event the input queue cannot take right away is pooled and
+ * drained in order. A full pool applies the instance's emit-policy: drop the oldest
+ * relative event, merge into the newest pending one of the same code, or wait for the
+ * input queue. Only the work queues of the report timers wait; the input thread cannot
+ * wait on its own queue, so there blocking falls back to merging, as it does while another
+ * drain has an event in flight.
+ */
+static void emit_event(struct absolute_to_relative_data *data, uint8_t type, uint16_t code,
+                       int32_t value, bool sync) {
+#if EMIT_POOL_SIZE > 0
+    /* emit-policy is not tunable; the devicetree config is read without holding a copy */
+    const struct absolute_to_relative_config *config = data->dev->config;
+    struct emit_pool *pool = &data->pool;
+
+    k_spinlock_key_t key = k_spin_lock(&pool->lock);
+    if (pool->count == 0 && !pool->in_flight) {
+        k_spin_unlock(&pool->lock, key);
+        if (input_report(data->dev, type, code, value, sync, K_NO_WAIT) == 0) {
+            STATS_INC(data, emitted);
+            return;
+        }
+        key = k_spin_lock(&pool->lock);
+    }
+
+    if (pool->count == EMIT_POOL_SIZE && config->emit_policy == EMIT_BLOCK &&
+        (k_current_get() == k_work_queue_thread_get(&k_sys_work_q) ||
+         k_current_get() == k_work_queue_thread_get(zip_accumulator_queue()))) {
+        k_spin_unlock(&pool->lock, key);
+        pool_drain(data, K_FOREVER);
+        key = k_spin_lock(&pool->lock);
+    }
+
+    if (pool->count == EMIT_POOL_SIZE) {
+        if (config->emit_policy != EMIT_DROP_OLDEST &&
+            pool_merge(pool, type, code, value, sync)) {
+            STATS_INC(data, emit_merges);
+            k_spin_unlock(&pool->lock, key);
+            return;
+        }
+        pool_drop_oldest(pool);
+        STATS_INC(data, emit_drops);
+    }
+
+    *pool_entry(pool, pool->count) =
+        (struct emit_entry){.value = value, .code = code, .type = type, .sync = sync};
+    pool->count++;
+    k_spin_unlock(&pool->lock, key);
+
+    /* A pending retry is left untouched */
+    k_work_schedule(&pool->work, K_NO_WAIT);
+#else
+    input_report(data->dev, type, code, value, sync, K_NO_WAIT);
+    STATS_INC(data, emitted);
+#endif
+}
+
+/**
+ * Emit one combined pair of relative events from the processor device.
+ * Zero values are skipped and only the last event carries the sync flag.
+ */
+static void report_rel_pair(struct absolute_to_relative_data *data, uint16_t code_a, int32_t a,
+                            uint16_t code_b, int32_t b) {
+    if (a != 0) {
+        emit_event(data, INPUT_EV_REL, code_a, CLAMP(a, INT16_MIN, INT16_MAX), b == 0);
+    }
+    if (b != 0) {
+        emit_event(data, INPUT_EV_REL, code_b, CLAMP(b, INT16_MIN, INT16_MAX), true);
+    }
+}
+
+/**
+ * Flush the accumulated X/Y motion as one report
+ */
+static void flush_motion(struct absolute_to_relative_data *data) {
+    int32_t dx, dy;
+
+    zip_accumulator_take(&data->motion, 1, &dx, &dy);
+
+    if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
+        LOG_DBG("Coalesced report: rel_x: %d, rel_y: %d", dx, dy);
+    }
+
+    report_rel_pair(data, INPUT_REL_X, dx, INPUT_REL_Y, dy);
+}
+
+/**
+ * Two-finger scroll is active while exactly two contacts are down
+ */
+static inline bool scrolling(const struct absolute_to_relative_data *data,
+                             const struct absolute_to_relative_config *config) {
+    return INST_ENABLED(config, scroll_mode) && data->contact_count == 2;
+}
+
+/**
+ * Report timer period: the coalescing interval, or the edge motion tick without one
+ */
+static inline uint32_t report_period_ms(const struct absolute_to_relative_config *config) {
+    return TUNABLE_ENABLED(config, report_interval_ms) ? config->report_interval_ms
+                                                    : EDGE_MOTION_PERIOD_MS;
+}
 
-    /* Calculate delta and apply smoothing (use local prev to reduce memory access) */
-    int16_t delta = (int16_t)value - (int16_t)prev;
-    int16_t smooth_delta = (delta + *previous_delta) >> 1;
+/**
+ * Edge motion velocity on one axis: a constant speed towards the edge while the last
+ * position lies within edge_motion_border counts of it, 0 otherwise
+ */
+static inline int32_t edge_velocity(const struct absolute_to_relative_data *data, enum axis axis,
+                                    int32_t min, int32_t max,
+                                    const struct absolute_to_relative_config *config) {
+    const int32_t pos = data->axes[axis].previous;
+
+    if (data->uninitialized & BIT(axis)) {
+        return 0;
+    }
+    if (pos < min + config->edge_motion_border) {
+        return -(int32_t)config->edge_motion_speed;
+    }
+    if (pos > max - config->edge_motion_border) {
+        return config->edge_motion_speed;
+    }
+    return 0;
+}
+
+/**
+ * Palm rejection is configured (pressure or contact size threshold)
+ */
+static inline bool palm_rejection(const struct absolute_to_relative_config *config) {
+    return INST_ENABLED(config, palm_pressure) || INST_ENABLED(config, palm_touch_major);
+}
+
+/**
+ * A single-touch or MT touch is down
+ */
+static inline bool touch_active(const struct absolute_to_relative_data *data) {
+    return data->touching || data->primary_slot != NO_CONTACT;
+}
+
+/**
+ * Arm the report timer for the timed stages (edge motion, inertia) when a touch starts
+ */
+static inline void touch_timer_start(struct absolute_to_relative_data *data,
+                                     const struct absolute_to_relative_config *config) {
+    if (INST_ENABLED(config, edge_motion_border) || INST_ENABLED(config, inertia_decay)) {
+        zip_accumulator_schedule(&data->motion, report_period_ms(config));
+    }
+}
+
+/**
+ * Output from a report timer stage. With a report interval it joins the coalesced report;
+ * otherwise it is reported on its own so a half-accumulated frame is never split.
+ */
+static void report_timed(struct absolute_to_relative_data *data,
+                         const struct absolute_to_relative_config *config, int32_t x,
+                         int32_t y) {
+    if (TUNABLE_ENABLED(config, report_interval_ms)) {
+        zip_accumulator_add(&data->motion, x, y);
+    } else {
+        report_rel_pair(data, INPUT_REL_X, x, INPUT_REL_Y, y);
+    }
+}
+
+/**
+ * One edge motion tick, run from the report timer while a touch is down. A rejected palm
+ * usually rests in the border band, so its session gets no edge motion either.
+ */
+static void edge_motion(struct absolute_to_relative_data *data,
+                        const struct absolute_to_relative_config *config) {
+    if ((palm_rejection(config) && data->palm) || scrolling(data, config)) {
+        return;
+    }
+
+    int32_t vx, vy;
+    transform_pair(data,
+                   edge_velocity(data, AXIS_X, config->abs_x_min, config->abs_x_max, config)
+                       << FILTER_FRAC_BITS,
+                   edge_velocity(data, AXIS_Y, config->abs_y_min, config->abs_y_max, config)
+                       << FILTER_FRAC_BITS,
+                   &vx, &vy);
+    vx >>= FILTER_FRAC_BITS;
+    vy >>= FILTER_FRAC_BITS;
+    if (vx == 0 && vy == 0) {
+        return;
+    }
+
+    if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
+        LOG_DBG("Edge motion: rel_x: %d, rel_y: %d", vx, vy);
+    }
+
+    report_timed(data, config, vx, vy);
+}
+
+/**
+ * Add one converted event to the motion sampled by the inertia tick
+ */
+static inline void inertia_track(const struct input_event *event,
+                                 struct absolute_to_relative_data *data) {
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    if (event->code == INPUT_REL_X) {
+        data->inertia_acc_x += event->value << FILTER_FRAC_BITS;
+    } else {
+        data->inertia_acc_y += event->value << FILTER_FRAC_BITS;
+    }
+    k_spin_unlock(&data->lock, key);
+}
+
+/**
+ * Stop gliding at once and forget the sampled velocity (next touch)
+ */
+static inline void inertia_stop(struct absolute_to_relative_data *data) {
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    data->inertia_acc_x = 0;
+    data->inertia_acc_y = 0;
+    data->inertia_velocity_x = 0;
+    data->inertia_velocity_y = 0;
+    data->inertia_remainder_x = 0;
+    data->inertia_remainder_y = 0;
+    k_spin_unlock(&data->lock, key);
+}
+
+/**
+ * One inertia tick. While touching, the velocity is a running average of the motion per
+ * tick; after the release it keeps coasting, decaying by inertia_decay/256 per tick,
+ * until it falls under inertia_min_speed. Returns true while the timer must keep running.
+ */
+static bool inertia_tick(struct absolute_to_relative_data *data,
+                         const struct absolute_to_relative_config *config) {
+    int32_t out_x = 0, out_y = 0;
+    bool gliding;
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    if (touch_active(data)) {
+        data->inertia_velocity_x = (data->inertia_velocity_x + data->inertia_acc_x) >> 1;
+        data->inertia_velocity_y = (data->inertia_velocity_y + data->inertia_acc_y) >> 1;
+        data->inertia_acc_x = 0;
+        data->inertia_acc_y = 0;
+        k_spin_unlock(&data->lock, key);
+        return true;
+    }
+
+    gliding = abs(data->inertia_velocity_x) >= config->inertia_min_speed ||
+              abs(data->inertia_velocity_y) >= config->inertia_min_speed;
+    if (gliding) {
+        out_x = zip_carry_round(data->inertia_velocity_x, &data->inertia_remainder_x,
+                                FILTER_FRAC_BITS);
+        out_y = zip_carry_round(data->inertia_velocity_y, &data->inertia_remainder_y,
+                                FILTER_FRAC_BITS);
+        data->inertia_velocity_x = (data->inertia_velocity_x * config->inertia_decay) >>
+                                   FILTER_FRAC_BITS;
+        data->inertia_velocity_y = (data->inertia_velocity_y * config->inertia_decay) >>
+                                   FILTER_FRAC_BITS;
+    } else {
+        data->inertia_velocity_x = 0;
+        data->inertia_velocity_y = 0;
+    }
+    k_spin_unlock(&data->lock, key);
+
+    if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG) && gliding) {
+        LOG_DBG("Inertia: rel_x: %d, rel_y: %d", out_x, out_y);
+    }
+
+    report_timed(data, config, out_x, out_y);
+    return gliding;
+}
+
+/**
+ * Report timer: coalesced reports, edge motion and inertia
+ */
+static void report_work_handler(struct k_work *work) {
+    struct absolute_to_relative_data *data =
+        CONTAINER_OF(zip_accumulator_from_work(work), struct absolute_to_relative_data, motion);
+    const struct absolute_to_relative_config *config = active_config_get(data->dev);
+
+    bool rearm = false;
+
+    /* Keep ticking for the whole touch, the finger may still slide into the border */
+    if (INST_ENABLED(config, edge_motion_border) && touch_active(data)) {
+        edge_motion(data, config);
+        rearm = true;
+    }
+    if (INST_ENABLED(config, inertia_decay)) {
+        rearm |= inertia_tick(data, config);
+    }
+    if (rearm) {
+        zip_accumulator_schedule(&data->motion, report_period_ms(config));
+    }
+
+    /* Frame mode without an interval flushes at the frame end instead */
+    if (TUNABLE_ENABLED(config, report_interval_ms) || !INST_ENABLED(config, frame_mode)) {
+        flush_motion(data);
+    }
+    active_config_put(data->dev, config);
+}
+
+/**
+ * Coalescing interval of the next report. With report_interval_max_ms it follows the
+ * averaged raw speed: report_interval_ms for slow precise motion, rising linearly to
+ * report_interval_max_ms at report_adaptive_speed counts per sample.
+ */
+static inline uint32_t report_interval(struct absolute_to_relative_data *data,
+                                       const struct absolute_to_relative_config *config) {
+    const uint32_t min = config->report_interval_ms;
+
+    if (!INST_ENABLED(config, report_interval_max_ms)) {
+        return min;
+    }
+
+    const uint32_t max = MAX(config->report_interval_max_ms, min);
+    const uint32_t speed =
+        abs(data->axes[AXIS_X].previous_delta) + abs(data->axes[AXIS_Y].previous_delta);
+
+    data->report_speed = (data->report_speed + MIN(speed, UINT16_MAX)) >> 1;
+    if (data->report_speed >= config->report_adaptive_speed) {
+        return max;
+    }
+    return min + (max - min) * data->report_speed / config->report_adaptive_speed;
+}
+
+/**
+ * Accumulate a converted relative event instead of forwarding it.
+ * With a report interval the first accumulated motion arms the report timer and later
+ * motion joins that report; in frame mode the caller flushes at the end of the frame.
+ */
+static int accumulate_motion(struct input_event *event, struct absolute_to_relative_data *data,
+                             const struct absolute_to_relative_config *config) {
+    if (event->code == INPUT_REL_X) {
+        zip_accumulator_add(&data->motion, event->value, 0);
+    } else {
+        zip_accumulator_add(&data->motion, 0, event->value);
+    }
+
+    /* An already pending report is left untouched */
+    if (TUNABLE_ENABLED(config, report_interval_ms)) {
+        zip_accumulator_schedule(&data->motion, report_interval(data, config));
+    }
+
+    event->code = COORD_INVALID_ZERO;
+    event->sync = false;
+    return ZMK_INPUT_PROC_STOP;
+}
+
+/**
+ * Flush whole scroll steps; the sub-step remainder stays accumulated for the next report.
+ * Moving the fingers up scrolls up (positive REL_WHEEL).
+ */
+static void flush_scroll(struct absolute_to_relative_data *data,
+                         const struct absolute_to_relative_config *config) {
+    /* Accumulators hold the Q8 sum of both contact deltas, i.e. twice the centroid delta */
+    const int32_t divisor = (int32_t)config->scroll_divisor << (1 + FILTER_FRAC_BITS);
+
+    int32_t hwheel, wheel;
+
+    zip_accumulator_take(&data->scroll, divisor, &hwheel, &wheel);
+    wheel = -wheel;
+
+    if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG) && (hwheel != 0 || wheel != 0)) {
+        LOG_DBG("Scroll report: hwheel: %d, wheel: %d", hwheel, wheel);
+    }
+
+    report_rel_pair(data, INPUT_REL_HWHEEL, hwheel, INPUT_REL_WHEEL, wheel);
+}
+
+/**
+ * Scroll report timer - runs at scroll-interval-ms independent of pointer reports
+ */
+static void scroll_work_handler(struct k_work *work) {
+    struct absolute_to_relative_data *data =
+        CONTAINER_OF(zip_accumulator_from_work(work), struct absolute_to_relative_data, scroll);
+    const struct absolute_to_relative_config *config = active_config_get(data->dev);
+
+    flush_scroll(data, config);
+    active_config_put(data->dev, config);
+}
+
+/**
+ * Pay back the prediction lead that is still ahead of the finger once motion stops, so a
+ * stop or lift never leaves the pointer overshooting. The payback joins the pending
+ * coalesced or frame motion; otherwise it is reported on its own.
+ */
+static void predict_settle(struct absolute_to_relative_data *data,
+                           const struct absolute_to_relative_config *config) {
+    int32_t out[2] = {0, 0};
+
+    for (int axis = 0; axis < AXIS_COUNT; axis++) {
+        struct axis_filter *filter = &data->axes[axis].filter;
+
+        out[data->axes[axis].map.rel_code == INPUT_REL_Y] +=
+            zip_carry_round(-filter->predicted, &filter->remainder, FILTER_FRAC_BITS);
+        filter->predicted = 0;
+    }
+
+    if (TUNABLE_ENABLED(config, report_interval_ms) || INST_ENABLED(config, frame_mode)) {
+        zip_accumulator_add(&data->motion, out[0], out[1]);
+    } else {
+        report_rel_pair(data, INPUT_REL_X, out[0], INPUT_REL_Y, out[1]);
+    }
+}
+
+/**
+ * Flush motion still pending when touch motion ends
+ */
+static inline void end_motion(struct absolute_to_relative_data *data,
+                              const struct absolute_to_relative_config *config) {
+    if (INST_ENABLED(config, prediction_ms)) {
+        predict_settle(data, config);
+    }
+
+    /* Flush remaining coalesced motion without waiting for the interval */
+    if (TUNABLE_ENABLED(config, report_interval_ms)) {
+        zip_accumulator_flush_now(&data->motion);
+    } else if (INST_ENABLED(config, frame_mode)) {
+        flush_motion(data);
+    }
+}
+
+/**
+ * Raise the idle state change event for this processor
+ */
+static void raise_idle_changed(struct absolute_to_relative_data *data, bool idle) {
+    if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
+        LOG_DBG("Pad %s", idle ? "idle" : "active");
+    }
+    raise_zmk_input_processor_idle_changed(
+        (struct zmk_input_processor_idle_changed){.dev = data->dev, .idle = idle});
+}
+
+/**
+ * Idle timer: no touch for idle_timeout_ms
+ */
+static void idle_work_handler(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct absolute_to_relative_data *data =
+        CONTAINER_OF(dwork, struct absolute_to_relative_data, idle_work);
+
+    /* A touch that raced with the timer keeps the pad active */
+    if (data->touching || data->contact_count > 0) {
+        return;
+    }
+    if (atomic_cas(&data->idle, false, true)) {
+        raise_idle_changed(data, true);
+    }
+}
+
+/**
+ * A touch started: stop the idle timer and leave idle
+ */
+static inline void activity_start(struct absolute_to_relative_data *data,
+                                  const struct absolute_to_relative_config *config) {
+    if (!INST_ENABLED(config, idle_timeout_ms)) {
+        return;
+    }
+    k_work_cancel_delayable(&data->idle_work);
+    if (atomic_cas(&data->idle, true, false)) {
+        raise_idle_changed(data, false);
+    }
+}
+
+/**
+ * The last touch ended: restart the idle timer
+ */
+static inline void activity_end(struct absolute_to_relative_data *data,
+                                const struct absolute_to_relative_config *config) {
+    if (INST_ENABLED(config, idle_timeout_ms)) {
+        k_work_reschedule(&data->idle_work, K_MSEC(config->idle_timeout_ms));
+    }
+}
+
+/**
+ * Report a BTN_0 press or release from the processor device
+ */
+static void report_button(struct absolute_to_relative_data *data, bool pressed) {
+    if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
+        LOG_DBG("Tap BTN_0 %s", pressed ? "press" : "release");
+    }
+    emit_event(data, INPUT_EV_KEY, INPUT_BTN_0, pressed, true);
+}
+
+/**
+ * End of the tap drag window: release the tap click
+ */
+static void tap_work_handler(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct absolute_to_relative_data *data =
+        CONTAINER_OF(dwork, struct absolute_to_relative_data, tap_work);
+
+    if (atomic_cas(&data->tap_state, TAP_PENDING, TAP_IDLE)) {
+        report_button(data, false);
+    }
+}
+
+/**
+ * Touch down: start measuring; a touch inside the drag window keeps BTN_0 held as a drag
+ */
+static inline void tap_touch_start(struct absolute_to_relative_data *data,
+                                   const struct absolute_to_relative_config *config) {
+    data->tap_start_ms = k_uptime_get_32();
+    data->tap_travel = 0;
+    data->tap_multi = false;
+
+    if (atomic_cas(&data->tap_state, TAP_PENDING, TAP_DRAGGING)) {
+        k_work_cancel_delayable(&data->tap_work);
+        if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
+            LOG_DBG("Tap-and-drag started");
+        }
+    }
+}
+
+/**
+ * Touch up: a short, still, single-contact touch is a tap.
+ * Without a drag window the click is pressed and released at once; with one, BTN_0 is
+ * pressed now and released when the window ends unless a new touch turns it into a drag.
+ */
+static void tap_touch_end(struct absolute_to_relative_data *data,
+                          const struct absolute_to_relative_config *config) {
+    const bool tap = !data->tap_multi && !data->palm &&
+                     data->tap_travel <= config->tap_max_travel &&
+                     k_uptime_get_32() - data->tap_start_ms <= config->tap_timeout_ms;
+
+    if (atomic_cas(&data->tap_state, TAP_DRAGGING, TAP_IDLE)) {
+        /* Drag ends with the touch; a tap as the second touch is a double click */
+        report_button(data, false);
+    }
+    if (!tap) {
+        return;
+    }
+
+    report_button(data, true);
+    if (INST_ENABLED(config, tap_drag_timeout_ms)) {
+        atomic_set(&data->tap_state, TAP_PENDING);
+        k_work_reschedule(&data->tap_work, K_MSEC(config->tap_drag_timeout_ms));
+    } else {
+        report_button(data, false);
+    }
+}
+
+/**
+ * A touch session starts (BTN_TOUCH or the first MT contact)
+ */
+static void touch_session_start(struct absolute_to_relative_data *data,
+                                const struct absolute_to_relative_config *config) {
+    touch_init(data);
+    STATS_INC(data, touch_sessions);
+    activity_start(data, config);
+    if (INST_ENABLED(config, inertia_decay)) {
+        inertia_stop(data);
+    }
+    if (INST_ENABLED(config, tap_timeout_ms)) {
+        tap_touch_start(data, config);
+    }
+    touch_timer_start(data, config);
+}
+
+/**
+ * The touch session ended (BTN_TOUCH release or the last MT contact lifted)
+ */
+static void touch_session_end(struct absolute_to_relative_data *data,
+                              const struct absolute_to_relative_config *config) {
+    activity_end(data, config);
+    if (INST_ENABLED(config, tap_timeout_ms)) {
+        tap_touch_end(data, config);
+    }
+    data->palm = false;
+}
 
+/**
+ * A pressure or contact size sample reached its threshold: drop the rest of the touch
+ * session, including motion still waiting to be reported
+ */
+static void palm_reject(struct absolute_to_relative_data *data,
+                        const struct absolute_to_relative_config *config, int32_t value) {
+    if (data->palm) {
+        return;
+    }
+    data->palm = true;
     if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
-        LOG_DBG("%s: %u -> rel_%s: %d (raw_delta: %d, smoothed: %d)",
-                (rel_code == INPUT_REL_X) ? "X" : "Y", value,
-                (rel_code == INPUT_REL_X) ? "x" : "y", smooth_delta, delta, smooth_delta);
+        LOG_DBG("Palm detected (%d) - touch session rejected", value);
     }
 
-    /* Update event and state */
-    event->type = INPUT_EV_REL;
-    event->code = rel_code;
-    event->value = smooth_delta;
-    *previous_delta = delta;
-    *previous_pos = value;
-    
-    return false; /* Signal to continue processing */
+    zip_accumulator_clear(&data->motion);
+    zip_accumulator_clear(&data->scroll);
+
+    if (INST_ENABLED(config, inertia_decay)) {
+        inertia_stop(data);
+    }
 }
 
 /**
- * Handle touch button events (BTN_TOUCH)
+ * Handle touch button events (BTN_TOUCH).
+ * MT pads may send BTN_TOUCH alongside their contacts; the session only starts and ends on
+ * transitions of touch_active(), so such a touch is counted (and tapped) once.
  */
 static int handle_touch_button(struct input_event *event, struct absolute_to_relative_data *data,
                                const struct absolute_to_relative_config *config) {
+    const bool was_active = touch_active(data);
+
     if (event->value == 1) {
         /* Touch started */
         data->touching = true;
-        touch_init(data);
+        if (!was_active) {
+            touch_session_start(data, config);
+        }
     } else {
         /* Touch ended */
         data->touching = false;
         if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
             LOG_DBG("Touch released");
         }
+        if (was_active && !touch_active(data)) {
+            end_motion(data, config);
+            touch_session_end(data, config);
+        }
     }
 
-    if (config->suppress_btn_touch) {
+    if (INST_ENABLED(config, suppress_btn_touch)) {
         if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
             LOG_DBG("Suppressing BTN_TOUCH");
         }
@@ -122,7 +1543,7 @@ static int handle_touch_button(struct input_event *event, struct absolute_to_rel
  * Handle button suppression (BTN_0)
  */
 static int handle_button_suppress(struct input_event *event, const struct absolute_to_relative_config *config) {
-    if (config->suppress_btn0) {
+    if (INST_ENABLED(config, suppress_btn0)) {
         if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
             LOG_DBG("Suppressing BTN_0");
         }
@@ -134,14 +1555,141 @@ static int handle_button_suppress(struct input_event *event, const struct absolu
 }
 
 /**
- * Main event handler - converts absolute input events to relative
+ * Handle ABS_MT_TRACKING_ID - a contact lands (id >= 0) or lifts (id == -1) in the current slot.
+ * The first contact becomes primary; when the primary lifts, the lowest active slot takes over
+ * with fresh pointer state so the hand-over does not jump.
  */
-static int absolute_to_relative_handle_event(const struct device *dev, struct input_event *event,
-                                             uint32_t param1, uint32_t param2,
-                                             struct zmk_input_processor_state *state) {
-    const struct absolute_to_relative_config *config = dev->config;
-    struct absolute_to_relative_data *data = (struct absolute_to_relative_data *)dev->data;
+static void handle_tracking_id(struct input_event *event, struct absolute_to_relative_data *data,
+                               const struct absolute_to_relative_config *config) {
+    const uint8_t slot = data->slot;
+    struct contact *contact = &data->contacts[slot];
+
+    if (event->value >= 0) {
+        if (contact->active) {
+            return;
+        }
+        contact->active = true;
+        contact->known = 0;
+        data->contact_count++;
+
+        if (data->primary_slot == NO_CONTACT) {
+            const bool was_active = touch_active(data);
+
+            data->primary_slot = slot;
+            if (!was_active) {
+                touch_session_start(data, config);
+            } else {
+                /* BTN_TOUCH already started the session: only start the contact afresh */
+                if (INST_ENABLED(config, prediction_ms)) {
+                    predict_settle(data, config);
+                }
+                touch_init(data);
+            }
+            return;
+        }
+
+        /* More than one finger: not a tap */
+        data->tap_multi = true;
+        if (scrolling(data, config)) {
+            /* Second finger down - pointer motion pauses, scroll starts from a clean state */
+            end_motion(data, config);
+            zip_accumulator_clear(&data->scroll);
+        }
+        return;
+    }
+
+    if (!contact->active) {
+        return;
+    }
+    contact->active = false;
+    data->contact_count--;
+
+    if (slot != data->primary_slot) {
+        if (INST_ENABLED(config, scroll_mode) && data->contact_count == 1) {
+            /* Scroll ended - resume the pointer without a jump from its stale position */
+            touch_init(data);
+        }
+        return;
+    }
+
+    data->primary_slot = NO_CONTACT;
+    for (uint8_t i = 0; i < MAX_CONTACTS && data->contact_count > 0; i++) {
+        if (data->contacts[i].active) {
+            data->primary_slot = i;
+            break;
+        }
+    }
+
+    if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
+        LOG_DBG("Primary contact %u lifted, new primary: %d", slot,
+                data->primary_slot == NO_CONTACT ? -1 : data->primary_slot);
+    }
+
+    end_motion(data, config);
+    touch_init(data);
+    if (!touch_active(data)) {
+        touch_session_end(data, config);
+    }
+}
+
+/**
+ * Add a contact delta to the two-finger scroll accumulator and arm the scroll timer
+ */
+static inline void accumulate_scroll(struct absolute_to_relative_data *data,
+                                     const struct absolute_to_relative_config *config,
+                                     enum axis axis, int32_t previous, int32_t value) {
+    const int16_t delta = position_delta(value, previous);
+    const struct axis_map *map = &data->axes[axis].map;
+    const int32_t scaled = (int32_t)delta * map->gain;
+
+    if (map->rel_code == INPUT_REL_X) {
+        zip_accumulator_add(&data->scroll, scaled, 0);
+    } else {
+        zip_accumulator_add(&data->scroll, 0, scaled);
+    }
+
+    if (INST_ENABLED(config, scroll_interval_ms)) {
+        zip_accumulator_schedule(&data->scroll, config->scroll_interval_ms);
+    }
+}
+
+/**
+ * Track an ABS_MT_POSITION_X/Y sample for the current slot.
+ * Returns true if the sample belongs to the primary contact and should drive the pointer.
+ */
+static inline bool track_contact_position(struct input_event *event,
+                                          struct absolute_to_relative_data *data,
+                                          const struct absolute_to_relative_config *config) {
+    const uint8_t slot = data->slot;
+
+    if (slot >= MAX_CONTACTS || !data->contacts[slot].active) {
+        return false;
+    }
+
+    struct contact *contact = &data->contacts[slot];
+    const enum axis axis = code_axis[event->code];
+    const int32_t value = axis_position(event->value, axis, config);
+    int32_t *position = (axis == AXIS_X) ? &contact->x : &contact->y;
+
+    if (scrolling(data, config)) {
+        if (!data->palm && (contact->known & BIT(axis))) {
+            accumulate_scroll(data, config, axis, *position, value);
+        }
+        *position = value;
+        contact->known |= BIT(axis);
+        return false;
+    }
+
+    *position = value;
+    contact->known |= BIT(axis);
+    return slot == data->primary_slot;
+}
 
+/**
+ * Convert a single event - rewrites it in place or hands it to the accumulator
+ */
+static int convert_event(struct input_event *event, struct absolute_to_relative_data *data,
+                         const struct absolute_to_relative_config *config) {
     /* Handle button events */
     if (event->type == INPUT_EV_KEY) {
         if (event->code == INPUT_BTN_TOUCH) {
@@ -152,27 +1700,368 @@ static int absolute_to_relative_handle_event(const struct device *dev, struct in
         }
     }
 
-    /* Only process absolute axis events when touching */
-    if (!data->touching || event->type != INPUT_EV_ABS) {
+    if (event->type != INPUT_EV_ABS) {
         return ZMK_INPUT_PROC_CONTINUE;
     }
 
     /* Convert absolute axes to relative motion */
-    bool suppress_event = false;
-    
-    if (event->code == INPUT_ABS_X) {
-        suppress_event = process_axis(event, &data->previous_x, &data->previous_dx, INPUT_REL_X);
-    } else if (event->code == INPUT_ABS_Y) {
-        suppress_event = process_axis(event, &data->previous_y, &data->previous_dy, INPUT_REL_Y);
+    switch (event->code) {
+    case INPUT_ABS_X:
+    case INPUT_ABS_Y:
+        /* Single-touch axes drive the pointer only while touching and no MT contact is tracked */
+        if (!data->touching || data->contact_count > 0) {
+            return ZMK_INPUT_PROC_CONTINUE;
+        }
+        break;
+    case INPUT_ABS_MT_SLOT:
+        data->slot = (event->value >= 0 && event->value < MAX_CONTACTS) ? event->value
+                                                                         : MAX_CONTACTS;
+        return ZMK_INPUT_PROC_CONTINUE;
+    case INPUT_ABS_MT_TRACKING_ID:
+        if (data->slot < MAX_CONTACTS) {
+            handle_tracking_id(event, data, config);
+        }
+        return ZMK_INPUT_PROC_CONTINUE;
+    case INPUT_ABS_MT_POSITION_X:
+    case INPUT_ABS_MT_POSITION_Y:
+        if (!track_contact_position(event, data, config)) {
+            return ZMK_INPUT_PROC_CONTINUE;
+        }
+        break;
+    case INPUT_ABS_PRESSURE:
+        if (INST_ENABLED(config, palm_pressure) && event->value >= config->palm_pressure) {
+            palm_reject(data, config, event->value);
+        }
+        return ZMK_INPUT_PROC_CONTINUE;
+    case INPUT_ABS_MT_TOUCH_MAJOR:
+        if (INST_ENABLED(config, palm_touch_major) && event->value >= config->palm_touch_major) {
+            palm_reject(data, config, event->value);
+        }
+        return ZMK_INPUT_PROC_CONTINUE;
+    default:
+        return ZMK_INPUT_PROC_CONTINUE;
+    }
+
+    if (palm_rejection(config) && data->palm) {
+        STATS_INC(data, palm_drops);
+        event->code = COORD_INVALID_ZERO;
+        event->sync = false;
+        return ZMK_INPUT_PROC_STOP;
+    }
+
+    const enum axis axis = code_axis[event->code];
+    struct axis_state *state = &data->axes[axis];
+
+    const enum axis_result result = process_axis(event, axis, data, config);
+
+    if (result != AXIS_CONVERTED) {
+        return (result == AXIS_PASSED) ? ZMK_INPUT_PROC_CONTINUE : ZMK_INPUT_PROC_STOP;
+    }
+
+    if (INST_ENABLED(config, tap_timeout_ms)) {
+        /* Raw sensor travel, before smoothing and the deadzone */
+        data->tap_travel += abs(state->previous_delta);
     }
 
-    if (suppress_event) {
+    if (TUNABLE_ENABLED(config, deadzone) && deadzone_gate(event, &state->filter, data, config)) {
+        STATS_INC(data, deadzone_drops);
         return ZMK_INPUT_PROC_STOP;
     }
 
+    if (INST_ENABLED(config, inertia_decay)) {
+        inertia_track(event, data);
+    }
+
+    if ((TUNABLE_ENABLED(config, report_interval_ms) || INST_ENABLED(config, frame_mode)) &&
+        event->type == INPUT_EV_REL) {
+        return accumulate_motion(event, data, config);
+    }
+
     return ZMK_INPUT_PROC_CONTINUE;
 }
 
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_STATS)
+/**
+ * Count one handled event and add its handler cycles to the log2 histogram
+ */
+static inline void stats_record(struct absolute_to_relative_data *data, int ret, timing_t start) {
+    timing_t end = timing_counter_get();
+    const uint64_t cycles = timing_cycles_get(&start, &end);
+    const uint8_t bucket = find_msb_set((uint32_t)MIN(cycles, UINT32_MAX));
+
+    data->stats.events_in++;
+    if (ret == ZMK_INPUT_PROC_STOP) {
+        data->stats.suppressed++;
+    }
+    data->stats.cycles_hist[MIN(bucket, STATS_HIST_BUCKETS - 1)]++;
+    data->stats.cycles_total += cycles;
+}
+#endif
+
+/**
+ * Process one event, including frame-mode flushing - shared by the per-event and batch paths
+ */
+static inline int process_event(struct input_event *event, struct absolute_to_relative_data *data,
+                                const struct absolute_to_relative_config *config) {
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_STATS)
+    const timing_t start = timing_counter_get();
+#endif
+    /* Latch the frame boundary before conversion clears the sync flag */
+    const bool frame_end = event->sync;
+    const int ret = convert_event(event, data, config);
+
+    /* Frame mode: emit the buffered X/Y of this sensor frame as one synced pair */
+    if (INST_ENABLED(config, frame_mode) && !TUNABLE_ENABLED(config, report_interval_ms) &&
+        frame_end) {
+        flush_motion(data);
+    }
+    if (INST_ENABLED(config, scroll_mode) && !INST_ENABLED(config, scroll_interval_ms) &&
+        frame_end) {
+        flush_scroll(data, config);
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_STATS)
+    stats_record(data, ret, start);
+#endif
+
+    return ret;
+}
+
+/**
+ * Main event handler - converts absolute input events to relative
+ */
+static int absolute_to_relative_handle_event(const struct device *dev, struct input_event *event,
+                                             uint32_t param1, uint32_t param2,
+                                             struct zmk_input_processor_state *state) {
+    const struct absolute_to_relative_config *config = active_config_get(dev);
+    struct absolute_to_relative_data *data = (struct absolute_to_relative_data *)dev->data;
+    const int ret = process_event(event, data, config);
+
+    active_config_put(dev, config);
+    return ret;
+}
+
+/**
+ * Batch event handler - converts a whole sensor frame with config/data loaded once.
+ * Stopped events are compacted out; returns the number of events left to forward.
+ */
+static int absolute_to_relative_handle_batch(const struct device *dev, struct input_event *events,
+                                             size_t count, uint32_t param1, uint32_t param2,
+                                             struct zmk_input_processor_state *state) {
+    const struct absolute_to_relative_config *config = active_config_get(dev);
+    struct absolute_to_relative_data *data = (struct absolute_to_relative_data *)dev->data;
+    size_t kept = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        if (process_event(&events[i], data, config) == ZMK_INPUT_PROC_CONTINUE) {
+            if (kept != i) {
+                events[kept] = events[i];
+            }
+            kept++;
+        }
+    }
+
+    active_config_put(dev, config);
+    return kept;
+}
+
+uint8_t zip_absolute_to_relative_contact_count(const struct device *dev) {
+    const struct absolute_to_relative_data *data = dev->data;
+
+    return data->contact_count;
+}
+
+int zip_absolute_to_relative_primary_slot(const struct device *dev) {
+    const struct absolute_to_relative_data *data = dev->data;
+
+    return data->primary_slot == NO_CONTACT ? -ENODATA : data->primary_slot;
+}
+
+int zip_absolute_to_relative_get_contact(const struct device *dev, uint8_t slot,
+                                         struct zip_absolute_to_relative_contact *contact) {
+    const struct absolute_to_relative_data *data = dev->data;
+
+    if (slot >= MAX_CONTACTS) {
+        return -EINVAL;
+    }
+    if (!data->contacts[slot].active) {
+        return -ENODATA;
+    }
+
+    contact->x = data->contacts[slot].x;
+    contact->y = data->contacts[slot].y;
+    contact->valid = (data->contacts[slot].known == AXES_ALL);
+    contact->primary = (slot == data->primary_slot);
+    return 0;
+}
+
+#if RUNTIME_PARAMS
+/* Serializes writers of the runtime parameter buffers */
+static K_MUTEX_DEFINE(params_mutex);
+
+static int params_validate(const struct zip_absolute_to_relative_params *params) {
+    if (params->filter > FILTER_ONE_EURO ||
+        !IN_RANGE(params->filter_min_alpha, 1, FILTER_ONE) ||
+        params->filter_beta > ONE_EURO_BETA_MAX || params->accel_points > ACCEL_MAX_POINTS) {
+        return -EINVAL;
+    }
+
+    for (uint8_t i = 0; i < params->accel_points; i++) {
+        const uint32_t speed = params->accel_curve[2 * i];
+
+        if (speed > ACCEL_SPEED_MAX || params->accel_curve[2 * i + 1] > ACCEL_GAIN_MAX ||
+            (i > 0 && speed <= params->accel_curve[2 * i - 2])) {
+            return -EINVAL;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Fill the inactive config copy with the new parameters and publish it with one atomic
+ * pointer swap, so the event path sees either the old or the new block, never a mix.
+ * The inactive copy may still be held by a handler or timer that loaded it before the
+ * previous change; wait up to PARAMS_GRACE_MS for it to be put, or fail with -EBUSY.
+ * Must be called from a thread that does not itself hold a config copy.
+ */
+static int params_apply(const struct device *dev,
+                        const struct zip_absolute_to_relative_params *params) {
+    struct absolute_to_relative_data *data = dev->data;
+    const int err = params_validate(params);
+
+    if (err) {
+        return err;
+    }
+
+    k_mutex_lock(&params_mutex, K_FOREVER);
+    const struct absolute_to_relative_config *current = atomic_ptr_get(&data->active);
+    const uint8_t next_index = (current == &data->runtime[0]) ? 1 : 0;
+    struct absolute_to_relative_config *next = &data->runtime[next_index];
+
+    for (int waited = 0; atomic_get(&data->readers[next_index]) != 0; waited++) {
+        if (waited >= PARAMS_GRACE_MS) {
+            k_mutex_unlock(&params_mutex);
+            LOG_WRN("%s: parameters still in use, update refused", dev->name);
+            return -EBUSY;
+        }
+        k_sleep(K_MSEC(1));
+    }
+
+    *next = *current;
+    next->filter = params->filter;
+    next->filter_min_alpha = params->filter_min_alpha;
+    next->filter_beta = params->filter_beta;
+    next->report_interval_ms = params->report_interval_ms;
+    next->deadzone = params->deadzone;
+    memcpy(data->runtime_curve[next_index], params->accel_curve,
+           sizeof(data->runtime_curve[next_index]));
+    next->accel_curve = data->runtime_curve[next_index];
+    next->accel_points = params->accel_points;
+
+    atomic_ptr_set(&data->active, next);
+    k_mutex_unlock(&params_mutex);
+
+    LOG_INF("%s: parameters updated (filter=%u, report_interval_ms=%u, deadzone=%u)",
+            dev->name, params->filter, params->report_interval_ms, params->deadzone);
+    return 0;
+}
+
+int zip_absolute_to_relative_get_params(const struct device *dev,
+                                        struct zip_absolute_to_relative_params *params) {
+    const struct absolute_to_relative_config *config = active_config_get(dev);
+
+    memset(params, 0, sizeof(*params));
+    params->filter = config->filter;
+    params->filter_min_alpha = config->filter_min_alpha;
+    params->filter_beta = config->filter_beta;
+    params->report_interval_ms = config->report_interval_ms;
+    params->deadzone = config->deadzone;
+    params->accel_points = config->accel_points;
+    memcpy(params->accel_curve, config->accel_curve,
+           2 * config->accel_points * sizeof(params->accel_curve[0]));
+    active_config_put(dev, config);
+    return 0;
+}
+
+int zip_absolute_to_relative_set_params(const struct device *dev,
+                                        const struct zip_absolute_to_relative_params *params) {
+    const int err = params_apply(dev, params);
+
+    if (err) {
+        return err;
+    }
+
+#if IS_ENABLED(CONFIG_SETTINGS)
+    struct absolute_to_relative_data *data = dev->data;
+
+    /* Debounced: a burst of changes costs one flash write */
+    k_work_reschedule(&data->save_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
+#endif
+    return 0;
+}
+
+#if IS_ENABLED(CONFIG_SETTINGS)
+/**
+ * Save the active parameters under abs2rel/<device name>
+ */
+static void params_save_work_handler(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct absolute_to_relative_data *data =
+        CONTAINER_OF(dwork, struct absolute_to_relative_data, save_work);
+    struct zip_absolute_to_relative_params params;
+    char key[SETTINGS_MAX_NAME_LEN + 1];
+
+    zip_absolute_to_relative_get_params(data->dev, &params);
+    snprintf(key, sizeof(key), "abs2rel/%s", data->dev->name);
+
+    const int err = settings_save_one(key, &params, sizeof(params));
+    if (err) {
+        LOG_ERR("Failed to save parameters of %s (%d)", data->dev->name, err);
+    }
+}
+#endif
+#endif
+
+/**
+ * Fold scale, swap-xy, invert and rotation (in that order) into one 2x2 Q8 matrix,
+ * output = M * sensor delta. Each column has a single non-zero entry, so every sensor
+ * axis maps to one output axis and gain and the per-event cost is one multiply.
+ */
+static void transform_init(struct absolute_to_relative_data *data,
+                           const struct absolute_to_relative_config *config) {
+    int32_t m[2][2] = {{config->scale_x, 0}, {0, config->scale_y}};
+
+    if (config->swap_xy) {
+        for (int c = 0; c < 2; c++) {
+            const int32_t tmp = m[0][c];
+            m[0][c] = m[1][c];
+            m[1][c] = tmp;
+        }
+    }
+    for (int c = 0; c < 2; c++) {
+        m[0][c] = config->invert_x ? -m[0][c] : m[0][c];
+        m[1][c] = config->invert_y ? -m[1][c] : m[1][c];
+    }
+    for (uint8_t step = 0; step < config->rotation; step++) {
+        /* 90 degrees clockwise in screen coordinates: (x, y) -> (-y, x) */
+        for (int c = 0; c < 2; c++) {
+            const int32_t x = m[0][c];
+            m[0][c] = -m[1][c];
+            m[1][c] = x;
+        }
+    }
+
+    for (int axis = 0; axis < AXIS_COUNT; axis++) {
+        data->axes[axis].map.rel_code = (m[0][axis] != 0) ? INPUT_REL_X : INPUT_REL_Y;
+        data->axes[axis].map.gain = m[0][axis] + m[1][axis];
+    }
+
+    if (IS_ENABLED(CONFIG_ZMK_LOG_LEVEL_DBG)) {
+        LOG_DBG("Transform matrix [[%d %d] [%d %d]] (Q8)", m[0][0], m[0][1], m[1][0], m[1][1]);
+    }
+}
+
 /**
  * Device initialization
  */
@@ -182,9 +2071,41 @@ static int absolute_to_relative_init(const struct device *dev) {
 
     data->dev = dev;
     data->touching = false;
+    data->primary_slot = NO_CONTACT;
+    data->nominal_period_ticks = k_ms_to_ticks_ceil32(config->nominal_period_ms);
+    transform_init(data, config);
+    data->stale_timeout_ticks = k_ms_to_ticks_ceil32(config->stale_timeout_ms);
+    data->prediction_ticks = k_ms_to_ticks_ceil32(config->prediction_ms);
+#if RUNTIME_PARAMS
+    /* Start from the devicetree values; saved parameters are applied on settings load */
+    data->runtime[0] = *config;
+    memcpy(data->runtime_curve[0], config->accel_curve,
+           2 * config->accel_points * sizeof(data->runtime_curve[0][0]));
+    data->runtime[0].accel_curve = data->runtime_curve[0];
+    atomic_ptr_set(&data->active, &data->runtime[0]);
+#if IS_ENABLED(CONFIG_SETTINGS)
+    k_work_init_delayable(&data->save_work, params_save_work_handler);
+#endif
+#endif
+    zip_accumulator_init(&data->motion, report_work_handler);
+    zip_accumulator_init(&data->scroll, scroll_work_handler);
+#if EMIT_POOL_SIZE > 0
+    k_work_init_delayable(&data->pool.work, emit_work_handler);
+#endif
+    k_work_init_delayable(&data->idle_work, idle_work_handler);
+    k_work_init_delayable(&data->tap_work, tap_work_handler);
+    /* The pad is active until the first idle timeout after boot */
+    activity_end(data, config);
 
-    LOG_INF("Initialized (suppress_btn_touch=%d, suppress_btn0=%d)",
-            config->suppress_btn_touch, config->suppress_btn0);
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_STATS)
+    timing_init();
+    timing_start();
+#endif
+
+    LOG_INF("Initialized (suppress_btn_touch=%d, suppress_btn0=%d, frame_mode=%d, filter=%u, "
+            "report_interval_ms=%u)",
+            config->suppress_btn_touch, config->suppress_btn0, config->frame_mode,
+            config->filter, config->report_interval_ms);
 
     return 0;
 }
@@ -192,25 +2113,89 @@ static int absolute_to_relative_init(const struct device *dev) {
 /**
  * Driver API
  */
-static const struct zmk_input_processor_driver_api absolute_to_relative_driver_api = {
-    .handle_event = absolute_to_relative_handle_event,
+static const struct zip_input_processor_driver_api absolute_to_relative_driver_api = {
+    .base =
+        {
+            .handle_event = absolute_to_relative_handle_event,
+        },
+    .handle_batch = absolute_to_relative_handle_batch,
 };
 
+/* <min max> element of an optional ABS range property, 0 if unset */
+#define ABS_RANGE(n, prop, idx)                                                         \
+    COND_CODE_1(DT_INST_NODE_HAS_PROP(n, prop), (DT_INST_PROP_BY_IDX(n, prop, idx)), (0))
+
 /**
  * Device instantiation macro
  */
 #define ABSOLUTE_TO_RELATIVE_INST(n)                                                   \
+    BUILD_ASSERT(DT_INST_PROP_LEN_OR(n, acceleration_curve, 0) % 2 == 0 &&             \
+                     DT_INST_PROP_LEN_OR(n, acceleration_curve, 0) <= 2 * ACCEL_MAX_POINTS, \
+                 "acceleration-curve must hold up to 8 <speed gain> pairs");            \
+    BUILD_ASSERT(DT_INST_PROP_OR(n, edge_motion_border, 0) == 0 ||                     \
+                     (DT_INST_NODE_HAS_PROP(n, abs_x_range) &&                          \
+                      DT_INST_NODE_HAS_PROP(n, abs_y_range)),                           \
+                 "edge-motion-border requires abs-x-range and abs-y-range");            \
+    BUILD_ASSERT(IN_RANGE(DT_INST_PROP_OR(n, filter_min_alpha, 64), 1, FILTER_ONE) &&   \
+                     DT_INST_PROP_OR(n, filter_beta, 32) <= ONE_EURO_BETA_MAX,          \
+                 "filter-min-alpha must be 1-256 and filter-beta 0-32767");             \
+    BUILD_ASSERT(DT_INST_PROP_OR(n, report_interval_max_ms, 0) == 0 ||                 \
+                     DT_INST_PROP_OR(n, report_interval_ms, 0) > 0,                     \
+                 "report-interval-max-ms requires report-interval-ms");                 \
+    static const uint32_t processor_absolute_to_relative_accel_curve_##n[] =            \
+        DT_INST_PROP_OR(n, acceleration_curve, {0});                                    \
     static struct absolute_to_relative_data processor_absolute_to_relative_data_##n = {\
         .touching = false,                                                              \
-        .previous_x = COORD_UNINITIALIZED,                                              \
-        .previous_y = COORD_UNINITIALIZED,                                              \
-        .previous_dx = 0,                                                               \
-        .previous_dy = 0,                                                               \
+        .uninitialized = AXES_ALL,                                                      \
+        .primary_slot = NO_CONTACT,                                                     \
     };                                                                                  \
     static const struct absolute_to_relative_config                                    \
         processor_absolute_to_relative_config_##n = {                                  \
             .suppress_btn_touch = DT_INST_PROP_OR(n, suppress_btn_touch, false),       \
             .suppress_btn0 = DT_INST_PROP_OR(n, suppress_btn0, false),                 \
+            .frame_mode = DT_INST_PROP_OR(n, frame_mode, false),                       \
+            .filter = DT_INST_ENUM_IDX_OR(n, filter, FILTER_AVERAGE),                  \
+            .filter_taps_shift = DT_INST_ENUM_IDX_OR(n, filter_taps, 1) + 1,           \
+            .filter_min_alpha = DT_INST_PROP_OR(n, filter_min_alpha, 64),              \
+            .filter_beta = DT_INST_PROP_OR(n, filter_beta, 32),                        \
+            .report_interval_ms = DT_INST_PROP_OR(n, report_interval_ms, 0),           \
+            .report_interval_max_ms = DT_INST_PROP_OR(n, report_interval_max_ms, 0),   \
+            .report_adaptive_speed = MAX(DT_INST_PROP_OR(n, report_adaptive_speed, 32), 1), \
+            .scroll_mode = DT_INST_PROP_OR(n, scroll_mode, false),                     \
+            .scroll_divisor = MAX(DT_INST_PROP_OR(n, scroll_divisor, 8), 1),           \
+            .scroll_interval_ms = DT_INST_PROP_OR(n, scroll_interval_ms, 20),          \
+            .accel_curve = processor_absolute_to_relative_accel_curve_##n,              \
+            .accel_points = DT_INST_PROP_LEN_OR(n, acceleration_curve, 0) / 2,          \
+            .nominal_period_ms = DT_INST_PROP_OR(n, nominal_period_ms, 0),             \
+            .stale_timeout_ms = DT_INST_PROP_OR(n, stale_timeout_ms, 0),               \
+            .deadzone = DT_INST_PROP_OR(n, deadzone, 0),                               \
+            .deadzone_rest_samples =                                                   \
+                CLAMP(DT_INST_PROP_OR(n, deadzone_rest_samples, 8), 1, UINT8_MAX),     \
+            .idle_timeout_ms = DT_INST_PROP_OR(n, idle_timeout_ms, 0),                 \
+            .abs_x_min = ABS_RANGE(n, abs_x_range, 0),                                 \
+            .abs_x_max = ABS_RANGE(n, abs_x_range, 1),                                 \
+            .abs_y_min = ABS_RANGE(n, abs_y_range, 0),                                 \
+            .abs_y_max = ABS_RANGE(n, abs_y_range, 1),                                 \
+            .edge_motion_border = DT_INST_PROP_OR(n, edge_motion_border, 0),           \
+            .edge_motion_speed = DT_INST_PROP_OR(n, edge_motion_speed, 4),             \
+            .swap_xy = DT_INST_PROP_OR(n, swap_xy, false),                             \
+            .invert_x = DT_INST_PROP_OR(n, invert_x, false),                           \
+            .invert_y = DT_INST_PROP_OR(n, invert_y, false),                           \
+            .rotation = DT_INST_ENUM_IDX_OR(n, rotation, 0),                           \
+            .scale_x = CLAMP(DT_INST_PROP_OR(n, scale_x, 256), 1, TRANSFORM_SCALE_MAX),  \
+            .scale_y = CLAMP(DT_INST_PROP_OR(n, scale_y, 256), 1, TRANSFORM_SCALE_MAX),  \
+            .inertia_decay = MIN(DT_INST_PROP_OR(n, inertia_decay, 0), UINT8_MAX),     \
+            .inertia_min_speed = MAX(DT_INST_PROP_OR(n, inertia_min_speed, 128), 1),   \
+            .tap_timeout_ms = DT_INST_PROP_OR(n, tap_timeout_ms, 0),                   \
+            .tap_max_travel = DT_INST_PROP_OR(n, tap_max_travel, 16),                  \
+            .tap_drag_timeout_ms = DT_INST_PROP_OR(n, tap_drag_timeout_ms, 0),         \
+            .palm_pressure = DT_INST_PROP_OR(n, palm_pressure, 0),                     \
+            .palm_touch_major = DT_INST_PROP_OR(n, palm_touch_major, 0),               \
+            .max_jump = DT_INST_PROP_OR(n, max_jump, 0),                               \
+            .fast_start = DT_INST_PROP_OR(n, fast_start, false),                       \
+            .pass_first_position = DT_INST_PROP_OR(n, pass_first_position, false),     \
+            .prediction_ms = DT_INST_PROP_OR(n, prediction_ms, 0),                     \
+            .emit_policy = DT_INST_ENUM_IDX_OR(n, emit_policy, EMIT_DROP_OLDEST),      \
         };                                                                              \
     DEVICE_DT_INST_DEFINE(n, absolute_to_relative_init, NULL,                         \
                           &processor_absolute_to_relative_data_##n,                    \
@@ -219,3 +2204,202 @@ static const struct zmk_input_processor_driver_api absolute_to_relative_driver_a
                           &absolute_to_relative_driver_api);
 
 DT_INST_FOREACH_STATUS_OKAY(ABSOLUTE_TO_RELATIVE_INST)
+
+#define SHELL_COMMANDS                                                                     \
+    (IS_ENABLED(CONFIG_SHELL) && (IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_STATS) || RUNTIME_PARAMS))
+
+#if SHELL_COMMANDS || (RUNTIME_PARAMS && IS_ENABLED(CONFIG_SETTINGS))
+#define ABSOLUTE_TO_RELATIVE_DEVICE(n) DEVICE_DT_INST_GET(n),
+
+static const struct device *const instances[] = {
+    DT_INST_FOREACH_STATUS_OKAY(ABSOLUTE_TO_RELATIVE_DEVICE)};
+#endif
+
+#if RUNTIME_PARAMS && IS_ENABLED(CONFIG_SETTINGS)
+/**
+ * Restore saved parameters; a block saved by a different layout is ignored
+ */
+static int params_settings_set(const char *name, size_t len, settings_read_cb read_cb,
+                               void *cb_arg) {
+    for (size_t i = 0; i < ARRAY_SIZE(instances); i++) {
+        struct zip_absolute_to_relative_params params;
+
+        if (!settings_name_steq(name, instances[i]->name, NULL)) {
+            continue;
+        }
+        if (len != sizeof(params)) {
+            return -EINVAL;
+        }
+
+        const ssize_t rc = read_cb(cb_arg, &params, sizeof(params));
+        if (rc < 0) {
+            return rc;
+        }
+        return params_apply(instances[i], &params);
+    }
+
+    return -ENOENT;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(abs2rel, "abs2rel", NULL, params_settings_set, NULL, NULL);
+#endif
+
+#if SHELL_COMMANDS
+#include <zephyr/shell/shell.h>
+#include <string.h>
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_STATS)
+static int cmd_stats(const struct shell *sh, size_t argc, char **argv) {
+    for (size_t i = 0; i < ARRAY_SIZE(instances); i++) {
+        const struct absolute_to_relative_data *data = instances[i]->data;
+        const struct absolute_to_relative_stats *stats = &data->stats;
+
+        shell_print(sh, "%s: in %u, suppressed %u, passed %u, emitted %u", instances[i]->name,
+                    stats->events_in, stats->suppressed, stats->events_in - stats->suppressed,
+                    stats->emitted);
+        shell_print(sh, "  touch sessions %u, first-sample drops %u, deadzone drops %u",
+                    stats->touch_sessions, stats->first_sample_drops, stats->deadzone_drops);
+        shell_print(sh, "  palm drops %u, jump drops %u", stats->palm_drops, stats->jump_drops);
+#if EMIT_POOL_SIZE > 0
+        shell_print(sh, "  pool drops %u, pool merges %u", stats->emit_drops, stats->emit_merges);
+#endif
+
+        /* Benchmark summary: input rate, mean cost and output/input event ratio */
+        const int64_t elapsed_ms = MAX(k_uptime_get() - stats->since_ms, 1);
+        const uint32_t events_out = stats->events_in - stats->suppressed + stats->emitted;
+        const uint32_t in = MAX(stats->events_in, 1);
+
+        shell_print(sh, "  %u events/s, %u cycles/event (%u ns), output ratio %u%%",
+                    (uint32_t)(stats->events_in * 1000LL / elapsed_ms),
+                    (uint32_t)(stats->cycles_total / in),
+                    (uint32_t)(timing_cycles_to_ns(stats->cycles_total) / in),
+                    (uint32_t)(events_out * 100ULL / in));
+        shell_print(sh, "  handler cycles (log2 histogram):");
+        for (uint8_t b = 0; b < STATS_HIST_BUCKETS; b++) {
+            if (stats->cycles_hist[b] > 0) {
+                shell_print(sh, "    < %lu: %u", BIT(b), stats->cycles_hist[b]);
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int cmd_stats_reset(const struct shell *sh, size_t argc, char **argv) {
+    for (size_t i = 0; i < ARRAY_SIZE(instances); i++) {
+        struct absolute_to_relative_data *data = instances[i]->data;
+
+        memset(&data->stats, 0, sizeof(data->stats));
+        data->stats.since_ms = k_uptime_get();
+    }
+
+    shell_print(sh, "Statistics reset");
+    return 0;
+}
+
+#define STATS_SUBCMDS                                                                      \
+    SHELL_CMD(stats, NULL, "Show hot-path statistics", cmd_stats),                         \
+    SHELL_CMD(stats_reset, NULL, "Reset hot-path statistics", cmd_stats_reset),
+#else
+#define STATS_SUBCMDS
+#endif
+
+#if RUNTIME_PARAMS
+static const char *const filter_names[] = {"none", "average", "moving-average", "one-euro"};
+
+static int cmd_params(const struct shell *sh, size_t argc, char **argv) {
+    for (size_t i = 0; i < ARRAY_SIZE(instances); i++) {
+        struct zip_absolute_to_relative_params params;
+
+        zip_absolute_to_relative_get_params(instances[i], &params);
+        shell_print(sh, "%s: filter %s, filter-min-alpha %u, filter-beta %u", instances[i]->name,
+                    filter_names[params.filter], params.filter_min_alpha, params.filter_beta);
+        shell_print(sh, "  report-interval-ms %u, deadzone %u, acceleration-curve points %u",
+                    params.report_interval_ms, params.deadzone, params.accel_points);
+        for (uint8_t p = 0; p < params.accel_points; p++) {
+            shell_print(sh, "    <%u %u>", params.accel_curve[2 * p],
+                        params.accel_curve[2 * p + 1]);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * abs2rel set <device> <parameter> <value> [value...]
+ */
+static int cmd_set(const struct shell *sh, size_t argc, char **argv) {
+    const struct device *dev = NULL;
+    struct zip_absolute_to_relative_params params;
+    const char *name = argv[2];
+    const uint32_t value = strtoul(argv[3], NULL, 0);
+
+    for (size_t i = 0; i < ARRAY_SIZE(instances); i++) {
+        if (strcmp(argv[1], instances[i]->name) == 0) {
+            dev = instances[i];
+        }
+    }
+    if (dev == NULL) {
+        shell_error(sh, "Unknown device %s", argv[1]);
+        return -ENODEV;
+    }
+
+    zip_absolute_to_relative_get_params(dev, &params);
+
+    if (strcmp(name, "filter") == 0) {
+        params.filter = ARRAY_SIZE(filter_names);
+        for (uint8_t f = 0; f < ARRAY_SIZE(filter_names); f++) {
+            if (strcmp(argv[3], filter_names[f]) == 0) {
+                params.filter = f;
+            }
+        }
+    } else if (strcmp(name, "filter-min-alpha") == 0) {
+        params.filter_min_alpha = MIN(value, UINT16_MAX);
+    } else if (strcmp(name, "filter-beta") == 0) {
+        params.filter_beta = MIN(value, UINT16_MAX);
+    } else if (strcmp(name, "report-interval-ms") == 0) {
+        params.report_interval_ms = value;
+    } else if (strcmp(name, "deadzone") == 0) {
+        params.deadzone = MIN(value, UINT16_MAX);
+    } else if (strcmp(name, "acceleration-curve") == 0) {
+        const size_t values = argc - 3;
+
+        /* A single 0 clears the curve */
+        if (values == 1 && value == 0) {
+            params.accel_points = 0;
+        } else if (values % 2 != 0 || values > ARRAY_SIZE(params.accel_curve)) {
+            shell_error(sh, "Expected 0 or up to %d <speed gain> pairs", ACCEL_MAX_POINTS);
+            return -EINVAL;
+        } else {
+            params.accel_points = values / 2;
+            for (size_t v = 0; v < values; v++) {
+                params.accel_curve[v] = strtoul(argv[3 + v], NULL, 0);
+            }
+        }
+    } else {
+        shell_error(sh, "Unknown parameter %s", name);
+        return -EINVAL;
+    }
+
+    const int err = zip_absolute_to_relative_set_params(dev, &params);
+    if (err) {
+        shell_error(sh, (err == -EBUSY) ? "Parameters busy, try again (%d)" : "Invalid value (%d)",
+                    err);
+        return err;
+    }
+
+    return 0;
+}
+
+#define PARAMS_SUBCMDS                                                                     \
+    SHELL_CMD(params, NULL, "Show runtime parameters", cmd_params),                        \
+    SHELL_CMD_ARG(set, NULL, "Set a runtime parameter: <device> <parameter> <value>...",   \
+                  cmd_set, 4, 2 * ACCEL_MAX_POINTS - 1),
+#else
+#define PARAMS_SUBCMDS
+#endif
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_abs2rel, STATS_SUBCMDS PARAMS_SUBCMDS SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(abs2rel, &sub_abs2rel, "Absolute-to-relative input processor", NULL);
+#endif
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <drivers/input_processor_accumulator.h>
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_SHARED_TICK)
+/* Accumulators with a pending flush, and the uptime the tick is armed for if tick_armed */
+static struct zip_accumulator *tick_pending;
+static int64_t tick_deadline;
+static bool tick_armed;
+static struct k_spinlock tick_lock;
+static struct k_work_delayable tick_work;
+static bool tick_initialized;
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_SHARED_TICK_DEDICATED_QUEUE)
+K_THREAD_STACK_DEFINE(tick_work_stack, CONFIG_ZMK_INPUT_PROCESSOR_SHARED_TICK_STACK_SIZE);
+static struct k_work_q tick_work_q;
+#define TICK_QUEUE (&tick_work_q)
+#else
+#define TICK_QUEUE (&k_sys_work_q)
+#endif
+
+/**
+ * Shared tick: one wakeup runs every pending flush. Handlers that re-arm join the next tick.
+ * The tick is disarmed before the handlers run, so a re-arm from a handler, or from a thread
+ * preempting one, always reschedules it.
+ */
+static void tick_handler(struct k_work *work) {
+    k_spinlock_key_t key = k_spin_lock(&tick_lock);
+    struct zip_accumulator *acc = tick_pending;
+    tick_pending = NULL;
+    tick_armed = false;
+    k_spin_unlock(&tick_lock, key);
+
+    while (acc != NULL) {
+        struct zip_accumulator *next = acc->next;
+
+        key = k_spin_lock(&tick_lock);
+        acc->pending = false;
+        k_spin_unlock(&tick_lock, key);
+
+        acc->handler(&acc->work.work);
+        acc = next;
+    }
+}
+
+/**
+ * Queue a flush of @p acc in @p delay_ms and pull the shared tick in if that is earlier.
+ * An already pending flush keeps its place unless @p replace.
+ */
+static void tick_arm(struct zip_accumulator *acc, uint32_t delay_ms, bool replace) {
+    const int64_t deadline = k_uptime_get() + delay_ms;
+
+    k_spinlock_key_t key = k_spin_lock(&tick_lock);
+    if (!acc->pending) {
+        acc->pending = true;
+        acc->next = tick_pending;
+        tick_pending = acc;
+    } else if (!replace) {
+        k_spin_unlock(&tick_lock, key);
+        return;
+    }
+
+    if (!tick_armed || deadline < tick_deadline) {
+        tick_armed = true;
+        tick_deadline = deadline;
+        k_work_reschedule_for_queue(TICK_QUEUE, &tick_work, K_MSEC(delay_ms));
+    }
+    k_spin_unlock(&tick_lock, key);
+}
+
+void zip_accumulator_schedule(struct zip_accumulator *acc, uint32_t delay_ms) {
+    tick_arm(acc, delay_ms, false);
+}
+
+void zip_accumulator_flush_now(struct zip_accumulator *acc) {
+    tick_arm(acc, 0, true);
+}
+
+struct k_work_q *zip_accumulator_queue(void) {
+    return TICK_QUEUE;
+}
+#endif
+
+void zip_accumulator_init(struct zip_accumulator *acc, k_work_handler_t handler) {
+    acc->x = 0;
+    acc->y = 0;
+    k_work_init_delayable(&acc->work, handler);
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_SHARED_TICK)
+    acc->handler = handler;
+    acc->pending = false;
+
+    /* Device init runs single-threaded, the first accumulator sets up the shared tick */
+    if (!tick_initialized) {
+        k_work_init_delayable(&tick_work, tick_handler);
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_SHARED_TICK_DEDICATED_QUEUE)
+        k_work_queue_start(&tick_work_q, tick_work_stack, K_THREAD_STACK_SIZEOF(tick_work_stack),
+                           CONFIG_ZMK_INPUT_PROCESSOR_SHARED_TICK_THREAD_PRIORITY, NULL);
+#endif
+        tick_initialized = true;
+    }
+#endif
+}
+
+void zip_accumulator_add(struct zip_accumulator *acc, int32_t x, int32_t y) {
+    k_spinlock_key_t key = k_spin_lock(&acc->lock);
+    acc->x += x;
+    acc->y += y;
+    k_spin_unlock(&acc->lock, key);
+}
+
+void zip_accumulator_take(struct zip_accumulator *acc, int32_t unit, int32_t *x, int32_t *y) {
+    k_spinlock_key_t key = k_spin_lock(&acc->lock);
+    *x = acc->x / unit;
+    *y = acc->y / unit;
+    acc->x -= *x * unit;
+    acc->y -= *y * unit;
+    k_spin_unlock(&acc->lock, key);
+}
+
+void zip_accumulator_clear(struct zip_accumulator *acc) {
+    k_spinlock_key_t key = k_spin_lock(&acc->lock);
+    acc->x = 0;
+    acc->y = 0;
+    k_spin_unlock(&acc->lock, key);
+}
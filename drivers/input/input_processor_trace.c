@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_input_processor_trace
+
+#include <stdio.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/input/input.h>
+#include <drivers/input_processor.h>
+#include <drivers/input_processor_batch.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/devicetree.h>
+
+LOG_MODULE_REGISTER(input_trace, CONFIG_ZMK_LOG_LEVEL);
+
+/* data->flags bits */
+#define TRACE_DRAIN_ARMED   0
+#define TRACE_HEADER_WRITTEN 1
+
+/* One captured event: 12 bytes, device pointer dropped */
+struct trace_record {
+    uint32_t timestamp; /* Ticks */
+    uint16_t code;
+    uint8_t type;
+    uint8_t sync;
+    int32_t value;
+};
+
+struct trace_config {
+    struct trace_record *buffer;
+    uint32_t mask; /* buffer-size - 1 */
+    uint32_t drain_interval_ms;
+    const struct device *uart; /* NULL: drain to the log subsystem */
+};
+
+/*
+ * Single-producer/single-consumer ring: the handler only writes head, the drain work only
+ * writes tail. Both are free-running counters, masked on access.
+ */
+struct trace_data {
+    atomic_t head;
+    atomic_t tail;
+    atomic_t dropped;
+    atomic_t flags;
+    struct k_work_delayable drain_work;
+    const struct device *dev;
+};
+
+K_THREAD_STACK_DEFINE(trace_work_stack, CONFIG_ZMK_INPUT_PROCESSOR_TRACE_STACK_SIZE);
+static struct k_work_q trace_work_q;
+static bool trace_work_q_started;
+
+/**
+ * Write one CSV line to the configured sink
+ */
+static void trace_write_line(const struct device *dev, const struct trace_config *config,
+                             const char *line) {
+    if (config->uart == NULL) {
+        LOG_INF("%s: %s", dev->name, line);
+        return;
+    }
+
+    for (const char *c = line; *c != '\0'; c++) {
+        uart_poll_out(config->uart, *c);
+    }
+    uart_poll_out(config->uart, '\r');
+    uart_poll_out(config->uart, '\n');
+}
+
+/**
+ * Drain work - formats captured records as CSV (ticks,type,code,value,sync)
+ */
+static void trace_drain_work_handler(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct trace_data *data = CONTAINER_OF(dwork, struct trace_data, drain_work);
+    const struct trace_config *config = data->dev->config;
+    char line[48];
+
+    /* Clear before reading head so events captured from now on re-arm the drain */
+    atomic_clear_bit(&data->flags, TRACE_DRAIN_ARMED);
+
+    if (!atomic_test_and_set_bit(&data->flags, TRACE_HEADER_WRITTEN)) {
+        snprintf(line, sizeof(line), "# ticks_per_sec=%u", CONFIG_SYS_CLOCK_TICKS_PER_SEC);
+        trace_write_line(data->dev, config, line);
+    }
+
+    const uint32_t head = atomic_get(&data->head);
+    uint32_t tail = atomic_get(&data->tail);
+
+    while (tail != head) {
+        const struct trace_record *record = &config->buffer[tail & config->mask];
+
+        snprintf(line, sizeof(line), "%u,%u,%u,%d,%u", record->timestamp, record->type,
+                 record->code, record->value, record->sync);
+        atomic_set(&data->tail, ++tail);
+        trace_write_line(data->dev, config, line);
+    }
+
+    const atomic_val_t dropped = atomic_clear(&data->dropped);
+    if (dropped > 0) {
+        snprintf(line, sizeof(line), "# dropped=%ld", (long)dropped);
+        trace_write_line(data->dev, config, line);
+    }
+}
+
+/**
+ * Event handler - copies the event into the ring and passes it on unchanged.
+ * No logging here; a full ring drops the record and counts it.
+ */
+static int trace_handle_event(const struct device *dev, struct input_event *event,
+                              uint32_t param1, uint32_t param2,
+                              struct zmk_input_processor_state *state) {
+    const struct trace_config *config = dev->config;
+    struct trace_data *data = (struct trace_data *)dev->data;
+    const uint32_t head = atomic_get(&data->head);
+
+    if (head - (uint32_t)atomic_get(&data->tail) > config->mask) {
+        atomic_inc(&data->dropped);
+        return ZMK_INPUT_PROC_CONTINUE;
+    }
+
+    config->buffer[head & config->mask] = (struct trace_record){
+        .timestamp = (uint32_t)k_uptime_ticks(),
+        .code = event->code,
+        .type = event->type,
+        .sync = event->sync,
+        .value = event->value,
+    };
+    atomic_set(&data->head, head + 1);
+
+    if (!atomic_test_and_set_bit(&data->flags, TRACE_DRAIN_ARMED)) {
+        k_work_schedule_for_queue(&trace_work_q, &data->drain_work,
+                                  K_MSEC(config->drain_interval_ms));
+    }
+
+    return ZMK_INPUT_PROC_CONTINUE;
+}
+
+/**
+ * Device initialization
+ */
+static int trace_init(const struct device *dev) {
+    struct trace_data *data = (struct trace_data *)dev->data;
+    const struct trace_config *config = dev->config;
+
+    data->dev = dev;
+    k_work_init_delayable(&data->drain_work, trace_drain_work_handler);
+
+    if (config->uart != NULL && !device_is_ready(config->uart)) {
+        LOG_ERR("Trace UART %s not ready", config->uart->name);
+        return -ENODEV;
+    }
+
+    /* One low-priority drain queue shared by all instances */
+    if (!trace_work_q_started) {
+        k_work_queue_start(&trace_work_q, trace_work_stack,
+                           K_THREAD_STACK_SIZEOF(trace_work_stack),
+                           CONFIG_ZMK_INPUT_PROCESSOR_TRACE_THREAD_PRIORITY, NULL);
+        trace_work_q_started = true;
+    }
+
+    LOG_INF("Initialized (buffer_size=%u, drain_interval_ms=%u, sink=%s)", config->mask + 1,
+            config->drain_interval_ms, config->uart != NULL ? config->uart->name : "log");
+
+    return 0;
+}
+
+/**
+ * Driver API
+ */
+static const struct zip_input_processor_driver_api trace_driver_api = {
+    .base =
+        {
+            .handle_event = trace_handle_event,
+        },
+    .handle_batch = NULL,
+};
+
+/**
+ * Device instantiation macro
+ */
+#define TRACE_INST(n)                                                                  \
+    BUILD_ASSERT(IS_POWER_OF_TWO(DT_INST_PROP(n, buffer_size)),                        \
+                 "buffer-size must be a power of two");                                \
+    static struct trace_record processor_trace_buffer_##n[DT_INST_PROP(n, buffer_size)]; \
+    static struct trace_data processor_trace_data_##n;                                 \
+    static const struct trace_config processor_trace_config_##n = {                    \
+        .buffer = processor_trace_buffer_##n,                                          \
+        .mask = DT_INST_PROP(n, buffer_size) - 1,                                      \
+        .drain_interval_ms = DT_INST_PROP_OR(n, drain_interval_ms, 100),               \
+        .uart = COND_CODE_1(DT_INST_NODE_HAS_PROP(n, uart),                            \
+                            (DEVICE_DT_GET(DT_INST_PHANDLE(n, uart))), (NULL)),         \
+    };                                                                                 \
+    DEVICE_DT_INST_DEFINE(n, trace_init, NULL, &processor_trace_data_##n,              \
+                          &processor_trace_config_##n, POST_KERNEL,                    \
+                          CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &trace_driver_api);
+
+DT_INST_FOREACH_STATUS_OKAY(TRACE_INST)
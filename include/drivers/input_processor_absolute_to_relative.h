@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/device.h>
+
+/**
+ * Multi-touch contact tracked by an absolute-to-relative processor.
+ * Coordinates are the last reported ABS_MT_POSITION_X/Y, bounded to abs-x-range and
+ * abs-y-range when those are set.
+ */
+struct zip_absolute_to_relative_contact {
+    int32_t x, y;
+    bool valid;   /* Both coordinates have been reported since the contact landed */
+    bool primary; /* This contact drives pointer motion */
+};
+
+/**
+ * Number of contacts currently down.
+ * Intended for processors later in the same listener chain (e.g. gesture processors).
+ */
+uint8_t zip_absolute_to_relative_contact_count(const struct device *dev);
+
+/**
+ * Slot of the contact driving pointer motion, or -ENODATA if no contact is down.
+ */
+int zip_absolute_to_relative_primary_slot(const struct device *dev);
+
+/**
+ * Read the contact in @p slot.
+ * Returns 0 on success, -EINVAL if the slot is out of range, -ENODATA if it is not down.
+ */
+int zip_absolute_to_relative_get_contact(const struct device *dev, uint8_t slot,
+                                         struct zip_absolute_to_relative_contact *contact);
+
+/* Maximum <speed gain> points of an acceleration curve */
+#define ZIP_ABSOLUTE_TO_RELATIVE_ACCEL_MAX_POINTS 8
+
+/**
+ * Runtime-tunable parameters
+ * (CONFIG_ZMK_INPUT_PROCESSOR_ABSOLUTE_TO_RELATIVE_RUNTIME_PARAMS).
+ * Units and ranges match the devicetree properties of the same name.
+ */
+struct zip_absolute_to_relative_params {
+    uint8_t filter; /* Index in the devicetree `filter` enum */
+    uint16_t filter_min_alpha;
+    uint16_t filter_beta;
+    uint32_t report_interval_ms;
+    uint16_t deadzone;
+    uint8_t accel_points;
+    uint32_t accel_curve[2 * ZIP_ABSOLUTE_TO_RELATIVE_ACCEL_MAX_POINTS];
+};
+
+/**
+ * Read the active parameters of @p dev.
+ */
+int zip_absolute_to_relative_get_params(const struct device *dev,
+                                        struct zip_absolute_to_relative_params *params);
+
+/**
+ * Validate and apply new parameters; with CONFIG_SETTINGS they are saved after a debounce.
+ * May sleep, so call it from a thread, never from an input processor or report handler.
+ * Returns 0 on success, -EINVAL if a value is out of range, or -EBUSY if a handler still
+ * holds the parameters from before the last change after a short grace period.
+ */
+int zip_absolute_to_relative_set_params(const struct device *dev,
+                                        const struct zip_absolute_to_relative_params *params);
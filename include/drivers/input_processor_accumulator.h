@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+
+/**
+ * Two-axis accumulator with a rate-limited flush timer, shared by the processors of this
+ * module (CONFIG_ZMK_INPUT_PROCESSOR_ACCUMULATOR).
+ *
+ * Values are summed in whatever fixed-point unit the caller uses; zip_accumulator_take()
+ * hands out whole multiples of a unit and keeps the remainder for the next flush. The
+ * embedded delayable work is the per-instance flush timer; its handler recovers the
+ * owner with zip_accumulator_from_work() and CONTAINER_OF().
+ *
+ * With CONFIG_ZMK_INPUT_PROCESSOR_SHARED_TICK the per-instance timers are replaced by one
+ * tick for all accumulators: it fires at the earliest requested deadline and runs the
+ * handler of every accumulator with a pending flush in that single wakeup.
+ */
+struct zip_accumulator {
+    struct k_spinlock lock;
+    int32_t x, y;
+    struct k_work_delayable work;
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_SHARED_TICK)
+    k_work_handler_t handler;
+    struct zip_accumulator *next; /* Shared tick: pending flush list */
+    bool pending;
+#endif
+};
+
+/**
+ * Initialize an accumulator and its flush timer, which runs @p handler
+ */
+void zip_accumulator_init(struct zip_accumulator *acc, k_work_handler_t handler);
+
+/**
+ * Add to both axes
+ */
+void zip_accumulator_add(struct zip_accumulator *acc, int32_t x, int32_t y);
+
+/**
+ * Take the whole multiples of @p unit from both axes (truncated towards zero); the
+ * remainder stays accumulated
+ */
+void zip_accumulator_take(struct zip_accumulator *acc, int32_t unit, int32_t *x, int32_t *y);
+
+/**
+ * Drop everything accumulated
+ */
+void zip_accumulator_clear(struct zip_accumulator *acc);
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_PROCESSOR_SHARED_TICK)
+/**
+ * Rate-limited flush: arm the timer for @p delay_ms unless a flush is already pending,
+ * so motion arriving in the meantime joins that flush
+ */
+void zip_accumulator_schedule(struct zip_accumulator *acc, uint32_t delay_ms);
+
+/**
+ * Flush as soon as possible, replacing a pending delay
+ */
+void zip_accumulator_flush_now(struct zip_accumulator *acc);
+
+/**
+ * Work queue the flush handlers run on
+ */
+struct k_work_q *zip_accumulator_queue(void);
+#else
+static inline void zip_accumulator_schedule(struct zip_accumulator *acc, uint32_t delay_ms) {
+    k_work_schedule(&acc->work, K_MSEC(delay_ms));
+}
+
+static inline void zip_accumulator_flush_now(struct zip_accumulator *acc) {
+    k_work_reschedule(&acc->work, K_NO_WAIT);
+}
+
+static inline struct k_work_q *zip_accumulator_queue(void) {
+    return &k_sys_work_q;
+}
+#endif
+
+/**
+ * Accumulator owning the flush timer work item passed to its handler
+ */
+static inline struct zip_accumulator *zip_accumulator_from_work(struct k_work *work) {
+    return CONTAINER_OF(k_work_delayable_from_work(work), struct zip_accumulator, work);
+}
+
+/**
+ * Round a fixed-point value with @p frac_bits fraction bits to whole counts and carry the
+ * fraction into @p remainder, so the emitted total never drifts more than half a count
+ * from the exact sum
+ */
+static inline int32_t zip_carry_round(int32_t value, int32_t *remainder, uint8_t frac_bits) {
+    const int32_t total = value + *remainder;
+    const int32_t counts = (total + (1 << (frac_bits - 1))) >> frac_bits;
+
+    *remainder = total - (counts << frac_bits);
+    return counts;
+}
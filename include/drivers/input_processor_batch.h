@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/device.h>
+#include <zephyr/input/input.h>
+#include <drivers/input_processor.h>
+
+/**
+ * Batch entry point for input processors of this module.
+ *
+ * Processes @p count events in place and compacts the array: events the processor stops
+ * are removed and the number of events left to forward is returned (negative errno on
+ * failure).
+ */
+typedef int (*zip_input_processor_handle_batch_callback_t)(const struct device *dev,
+                                                           struct input_event *events,
+                                                           size_t count, uint32_t param1,
+                                                           uint32_t param2,
+                                                           struct zmk_input_processor_state *state);
+
+/**
+ * Driver API of batch-capable processors.
+ *
+ * Every processor of this module must declare its API with this struct, setting
+ * handle_batch to NULL if it has no batch handler: zip_input_processor_handle_batch()
+ * reads handle_batch from any of them. The ZMK per-event API must stay the first member
+ * so devices keep working in the regular listener chain.
+ */
+struct zip_input_processor_driver_api {
+    struct zmk_input_processor_driver_api base;
+    zip_input_processor_handle_batch_callback_t handle_batch;
+};
+
+/**
+ * Per-event shim with the same compaction contract as handle_batch.
+ * Works with any ZMK input processor.
+ */
+static inline int zip_input_processor_handle_batch_fallback(const struct device *dev,
+                                                            struct input_event *events,
+                                                            size_t count, uint32_t param1,
+                                                            uint32_t param2,
+                                                            struct zmk_input_processor_state *state) {
+    const struct zmk_input_processor_driver_api *api =
+        (const struct zmk_input_processor_driver_api *)dev->api;
+    size_t kept = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        int ret = api->handle_event(dev, &events[i], param1, param2, state);
+        if (ret < 0) {
+            return ret;
+        }
+        if (ret == ZMK_INPUT_PROC_CONTINUE) {
+            if (kept != i) {
+                events[kept] = events[i];
+            }
+            kept++;
+        }
+    }
+
+    return kept;
+}
+
+/**
+ * Run a batch of events through a processor of this module.
+ * Uses handle_batch when the processor provides one, per-event dispatch otherwise.
+ * Other ZMK processors must go through zip_input_processor_handle_batch_fallback().
+ */
+static inline int zip_input_processor_handle_batch(const struct device *dev,
+                                                   struct input_event *events, size_t count,
+                                                   uint32_t param1, uint32_t param2,
+                                                   struct zmk_input_processor_state *state) {
+    const struct zip_input_processor_driver_api *api =
+        (const struct zip_input_processor_driver_api *)dev->api;
+
+    if (api->handle_batch == NULL) {
+        return zip_input_processor_handle_batch_fallback(dev, events, count, param1, param2,
+                                                         state);
+    }
+
+    return api->handle_batch(dev, events, count, param1, param2, state);
+}
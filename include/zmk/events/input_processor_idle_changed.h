@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zmk/event_manager.h>
+
+/**
+ * Raised by an absolute-to-relative processor when its pad goes idle (no touch for
+ * idle-timeout-ms) and again when the next touch starts. Sensor drivers can subscribe to
+ * drop their polling rate while idle.
+ */
+struct zmk_input_processor_idle_changed {
+    const struct device *dev; /* Processor device */
+    bool idle;
+};
+
+ZMK_EVENT_DECLARE(zmk_input_processor_idle_changed);
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Stand-in for the ZMK event manager: events are declared and raised like in ZMK, but
+ * not dispatched to any listener.
+ */
+
+#pragma once
+
+#include <zephyr/sys/util.h>
+
+#define ZMK_EVENT_DECLARE(event_type) int raise_##event_type(struct event_type event);
+
+#define ZMK_EVENT_IMPL(event_type)                                                      \
+    int raise_##event_type(struct event_type event) {                                  \
+        ARG_UNUSED(event);                                                             \
+        return 0;                                                                      \
+    }                                                                                  \
+    BUILD_ASSERT(true)
@@ -0,0 +1,447 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Replays the checked-in traces through absolute-to-relative instances. Passthrough,
+ * coalescing and frame mode are checked against a reference model built from the same
+ * trace, the smoothing filters and the deadzone against the expected outputs in
+ * expected/, and the timed stages (acceleration, prediction) against invariants.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/input/input.h>
+#include <zephyr/ztest.h>
+
+#include "trace_replay.h"
+
+#define PASSTHROUGH_NODE    DT_NODELABEL(abs2rel_passthrough)
+#define COALESCE_NODE       DT_NODELABEL(abs2rel_coalesce)
+#define FRAME_NODE          DT_NODELABEL(abs2rel_frame)
+#define AVERAGE_NODE        DT_NODELABEL(abs2rel_average)
+#define MOVING_AVERAGE_NODE DT_NODELABEL(abs2rel_moving_average)
+#define ONE_EURO_NODE       DT_NODELABEL(abs2rel_one_euro)
+#define DEADZONE_NODE       DT_NODELABEL(abs2rel_deadzone)
+#define ACCEL_NODE          DT_NODELABEL(abs2rel_accel)
+#define PREDICT_NODE        DT_NODELABEL(abs2rel_predict)
+
+#define COALESCE_INTERVAL_MS DT_PROP(COALESCE_NODE, report_interval_ms)
+
+/* Gain of the last <speed gain> point of the acceleration curve, in 1/256 units */
+#define ACCEL_CURVE_GAIN_MAX DT_PROP_BY_IDX(ACCEL_NODE, acceleration_curve, 3)
+
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(PASSTHROUGH_NODE), trace_replay_capture, NULL);
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(COALESCE_NODE), trace_replay_capture, NULL);
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(FRAME_NODE), trace_replay_capture, NULL);
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(AVERAGE_NODE), trace_replay_capture, NULL);
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(MOVING_AVERAGE_NODE), trace_replay_capture, NULL);
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(ONE_EURO_NODE), trace_replay_capture, NULL);
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(DEADZONE_NODE), trace_replay_capture, NULL);
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(ACCEL_NODE), trace_replay_capture, NULL);
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(PREDICT_NODE), trace_replay_capture, NULL);
+
+static const char trace_swipe[] = {
+#include "swipe.csv.inc"
+};
+
+static const char trace_strokes[] = {
+#include "strokes.csv.inc"
+};
+
+struct trace {
+    const char *name;
+    const char *csv;
+    size_t len;
+};
+
+static const struct trace traces[] = {
+    {"swipe", trace_swipe, sizeof(trace_swipe)},
+    {"strokes", trace_strokes, sizeof(trace_strokes)},
+};
+
+/* Expected outputs, as the trace processor would record them behind the instance */
+static const char expected_swipe_average[] = {
+#include "swipe.average.csv.inc"
+};
+
+static const char expected_swipe_moving_average[] = {
+#include "swipe.moving_average.csv.inc"
+};
+
+static const char expected_swipe_one_euro[] = {
+#include "swipe.one_euro.csv.inc"
+};
+
+static const char expected_swipe_deadzone[] = {
+#include "swipe.deadzone.csv.inc"
+};
+
+static const char expected_strokes_average[] = {
+#include "strokes.average.csv.inc"
+};
+
+static const char expected_strokes_moving_average[] = {
+#include "strokes.moving_average.csv.inc"
+};
+
+static const char expected_strokes_one_euro[] = {
+#include "strokes.one_euro.csv.inc"
+};
+
+static const char expected_strokes_deadzone[] = {
+#include "strokes.deadzone.csv.inc"
+};
+
+struct expected {
+    const char *name;
+    const struct device *dev;
+    const struct trace *trace;
+    const char *csv;
+    size_t len;
+};
+
+#define EXPECTED(_name, _node, _trace, _csv)                                            \
+    {_name, DEVICE_DT_GET(_node), &traces[_trace], _csv, sizeof(_csv)}
+
+static const struct expected expected[] = {
+    EXPECTED("swipe.average", AVERAGE_NODE, 0, expected_swipe_average),
+    EXPECTED("swipe.moving_average", MOVING_AVERAGE_NODE, 0, expected_swipe_moving_average),
+    EXPECTED("swipe.one_euro", ONE_EURO_NODE, 0, expected_swipe_one_euro),
+    EXPECTED("swipe.deadzone", DEADZONE_NODE, 0, expected_swipe_deadzone),
+    EXPECTED("strokes.average", AVERAGE_NODE, 1, expected_strokes_average),
+    EXPECTED("strokes.moving_average", MOVING_AVERAGE_NODE, 1, expected_strokes_moving_average),
+    EXPECTED("strokes.one_euro", ONE_EURO_NODE, 1, expected_strokes_one_euro),
+    EXPECTED("strokes.deadzone", DEADZONE_NODE, 1, expected_strokes_deadzone),
+};
+
+/* Reference model of the expected output, and what it saw in the trace */
+struct model {
+    struct input_event out[TRACE_OUTPUT_MAX];
+    size_t count;
+    int32_t travel_x, travel_y; /* Sum of the converted deltas */
+    uint32_t deltas;            /* Converted position samples */
+    uint32_t touches;
+    uint32_t duration_ms;
+};
+
+static struct trace_result result;
+static struct model model;
+
+static void model_add(struct model *m, uint8_t type, uint16_t code, int32_t value, bool sync) {
+    zassert_true(m->count < ARRAY_SIZE(m->out), "Reference model overflow");
+    m->out[m->count++] = (struct input_event){
+        .type = type, .code = code, .value = value, .sync = sync};
+}
+
+/**
+ * Walk a trace as the converter does without filtering: while touching, the first
+ * position on each axis is dropped and every later one becomes its delta. Without
+ * @p frame, each delta is forwarded in place; with it, the deltas of a sensor frame are
+ * reported as one pair when the frame's sync arrives. Everything else passes unchanged.
+ */
+static void model_build(struct model *m, const struct trace *trace, bool frame) {
+    struct trace_reader reader;
+    struct input_event event;
+    uint32_t ticks, first = 0, last = 0;
+    int32_t previous[2] = {0, 0};
+    int32_t pending[2] = {0, 0};
+    bool known[2] = {false, false};
+    bool touching = false;
+    int ret;
+
+    memset(m, 0, sizeof(*m));
+    trace_reader_init(&reader, trace->csv, trace->len);
+
+    while ((ret = trace_reader_next(&reader, &event, &ticks)) > 0) {
+        bool forwarded = true;
+
+        if (m->count == 0 && m->touches == 0) {
+            first = ticks;
+        }
+        last = ticks;
+
+        if (event.type == INPUT_EV_KEY && event.code == INPUT_BTN_TOUCH) {
+            touching = event.value != 0;
+            known[0] = known[1] = false;
+            m->touches += touching;
+        } else if (touching && event.type == INPUT_EV_ABS &&
+                   (event.code == INPUT_ABS_X || event.code == INPUT_ABS_Y)) {
+            const int axis = (event.code == INPUT_ABS_Y);
+            const int32_t delta = event.value - previous[axis];
+
+            forwarded = false;
+            previous[axis] = event.value;
+            if (known[axis]) {
+                m->deltas++;
+                if (axis == 0) {
+                    m->travel_x += delta;
+                } else {
+                    m->travel_y += delta;
+                }
+                if (frame) {
+                    pending[axis] += delta;
+                } else {
+                    model_add(m, INPUT_EV_REL, axis ? INPUT_REL_Y : INPUT_REL_X, delta,
+                              event.sync);
+                }
+            }
+            known[axis] = true;
+        }
+
+        /* Frame end: the buffered pair is reported before the event is forwarded */
+        if (frame && event.sync) {
+            if (pending[0] != 0) {
+                model_add(m, INPUT_EV_REL, INPUT_REL_X, pending[0], pending[1] == 0);
+            }
+            if (pending[1] != 0) {
+                model_add(m, INPUT_EV_REL, INPUT_REL_Y, pending[1], true);
+            }
+            pending[0] = pending[1] = 0;
+        }
+        if (forwarded) {
+            model_add(m, event.type, event.code, event.value, event.sync);
+        }
+    }
+
+    zassert_equal(ret, 0, "%s: malformed trace line %u", trace->name, reader.line);
+    m->duration_ms = (uint64_t)(last - first) * MSEC_PER_SEC / reader.ticks_per_sec;
+}
+
+/**
+ * Load an expected output trace as the reference model
+ */
+static void model_load(struct model *m, const struct expected *expected) {
+    struct trace_reader reader;
+    struct input_event event;
+    uint32_t ticks;
+    int ret;
+
+    memset(m, 0, sizeof(*m));
+    trace_reader_init(&reader, expected->csv, expected->len);
+
+    while ((ret = trace_reader_next(&reader, &event, &ticks)) > 0) {
+        model_add(m, event.type, event.code, event.value, event.sync);
+    }
+    zassert_equal(ret, 0, "%s: malformed expected line %u", expected->name, reader.line);
+}
+
+static void replay(const struct device *dev, const struct trace *trace) {
+    zassert_true(device_is_ready(dev), "%s not ready", dev->name);
+    zassert_ok(trace_replay(dev, trace->csv, trace->len, &result), "%s: replay failed",
+               trace->name);
+    zassert_false(result.overflow, "%s: output capture overflow", trace->name);
+    trace_replay_report(trace->name, &result);
+}
+
+static bool event_equal(const struct input_event *a, const struct input_event *b) {
+    return a->type == b->type && a->code == b->code && a->value == b->value &&
+           !a->sync == !b->sync;
+}
+
+static void assert_output_matches(const char *name, const struct model *m) {
+    bool equal = result.count == m->count;
+
+    for (size_t i = 0; equal && i < m->count; i++) {
+        equal = event_equal(&result.out[i].event, &m->out[i]);
+    }
+    if (equal) {
+        return;
+    }
+
+    trace_replay_dump(name, &result);
+    zassert_equal(result.count, m->count, "%s: %u events out, expected %u", name,
+                  (uint32_t)result.count, (uint32_t)m->count);
+
+    for (size_t i = 0; i < m->count; i++) {
+        const struct input_event *got = &result.out[i].event;
+        const struct input_event *want = &m->out[i];
+
+        zassert_true(event_equal(got, want), "%s: event %u is %u/%u/%d/%u, expected %u/%u/%d/%u",
+                     name, (uint32_t)i, got->type, got->code, got->value, got->sync, want->type,
+                     want->code, want->value, want->sync);
+    }
+}
+
+/**
+ * Add up the REL output of the last replay per axis, split into forwarded and reported
+ */
+static void output_travel(int32_t *x, int32_t *y, uint32_t *reported) {
+    *x = *y = 0;
+    *reported = 0;
+
+    for (size_t i = 0; i < result.count; i++) {
+        const struct trace_output *out = &result.out[i];
+
+        if (out->event.type != INPUT_EV_REL) {
+            continue;
+        }
+        *reported += out->reported;
+        if (out->event.code == INPUT_REL_X) {
+            *x += out->event.value;
+        } else {
+            *y += out->event.value;
+        }
+    }
+}
+
+ZTEST(abs2rel_replay, test_passthrough) {
+    for (size_t i = 0; i < ARRAY_SIZE(traces); i++) {
+        model_build(&model, &traces[i], false);
+        replay(DEVICE_DT_GET(PASSTHROUGH_NODE), &traces[i]);
+        assert_output_matches(traces[i].name, &model);
+
+        for (size_t j = 0; j < result.count; j++) {
+            zassert_false(result.out[j].reported, "%s: passthrough reported event %u",
+                          traces[i].name, (uint32_t)j);
+        }
+    }
+}
+
+ZTEST(abs2rel_replay, test_frame_mode) {
+    for (size_t i = 0; i < ARRAY_SIZE(traces); i++) {
+        model_build(&model, &traces[i], true);
+        replay(DEVICE_DT_GET(FRAME_NODE), &traces[i]);
+        assert_output_matches(traces[i].name, &model);
+
+        for (size_t j = 0; j < result.count; j++) {
+            const struct trace_output *out = &result.out[j];
+
+            zassert_equal(out->reported, out->event.type == INPUT_EV_REL,
+                          "%s: event %u: motion must be reported, buttons forwarded",
+                          traces[i].name, (uint32_t)j);
+        }
+    }
+}
+
+ZTEST(abs2rel_replay, test_coalescing) {
+    for (size_t i = 0; i < ARRAY_SIZE(traces); i++) {
+        int32_t sum_x = 0, sum_y = 0;
+        uint32_t motion_events = 0, reports = 0;
+
+        model_build(&model, &traces[i], false);
+        replay(DEVICE_DT_GET(COALESCE_NODE), &traces[i]);
+
+        for (size_t j = 0; j < result.count; j++) {
+            const struct trace_output *out = &result.out[j];
+
+            if (out->event.type != INPUT_EV_REL) {
+                zassert_false(out->reported, "%s: event %u: buttons are forwarded",
+                              traces[i].name, (uint32_t)j);
+                continue;
+            }
+            zassert_true(out->reported, "%s: event %u: motion must be reported",
+                         traces[i].name, (uint32_t)j);
+
+            motion_events++;
+            reports += out->event.sync;
+            if (out->event.code == INPUT_REL_X) {
+                sum_x += out->event.value;
+            } else {
+                sum_y += out->event.value;
+            }
+        }
+
+        /* No motion is lost or invented, only merged */
+        zassert_equal(sum_x, model.travel_x, "%s: REL_X total %d, expected %d",
+                      traces[i].name, sum_x, model.travel_x);
+        zassert_equal(sum_y, model.travel_y, "%s: REL_Y total %d, expected %d",
+                      traces[i].name, sum_y, model.travel_y);
+        zassert_true(motion_events < model.deltas, "%s: %u motion events for %u deltas",
+                     traces[i].name, motion_events, model.deltas);
+
+        /* At most one report per interval, plus the flush on each release */
+        zassert_true(reports <= model.duration_ms / COALESCE_INTERVAL_MS + 2 * model.touches,
+                     "%s: %u reports in %u ms", traces[i].name, reports, model.duration_ms);
+    }
+}
+
+ZTEST(abs2rel_replay, test_filters) {
+    for (size_t i = 0; i < ARRAY_SIZE(expected); i++) {
+        model_load(&model, &expected[i]);
+        replay(expected[i].dev, expected[i].trace);
+        assert_output_matches(expected[i].name, &model);
+
+        for (size_t j = 0; j < result.count; j++) {
+            zassert_false(result.out[j].reported, "%s: event %u is reported, not forwarded",
+                          expected[i].name, (uint32_t)j);
+        }
+    }
+}
+
+ZTEST(abs2rel_replay, test_acceleration) {
+    for (size_t i = 0; i < ARRAY_SIZE(traces); i++) {
+        uint32_t raw = 0, accelerated = 0;
+
+        model_build(&model, &traces[i], false);
+        replay(DEVICE_DT_GET(ACCEL_NODE), &traces[i]);
+        zassert_equal(result.count, model.count, "%s: %u events out, expected %u",
+                      traces[i].name, (uint32_t)result.count, (uint32_t)model.count);
+
+        /* Event for event: the same motion, scaled by a gain of 1x to the curve maximum */
+        for (size_t j = 0; j < result.count; j++) {
+            const struct input_event *got = &result.out[j].event;
+            const struct input_event *want = &model.out[j];
+
+            if (want->type != INPUT_EV_REL) {
+                zassert_true(event_equal(got, want), "%s: event %u changed", traces[i].name,
+                             (uint32_t)j);
+                continue;
+            }
+
+            const int32_t lo = abs(want->value) - 1;
+            const int32_t hi = abs(want->value) * ACCEL_CURVE_GAIN_MAX / 256 + 1;
+
+            zassert_true(got->type == want->type && got->code == want->code &&
+                             (got->value == 0 || (got->value < 0) == (want->value < 0)) &&
+                             IN_RANGE(abs(got->value), lo, hi),
+                         "%s: event %u is %d, expected %d scaled by 1x-%ux/256",
+                         traces[i].name, (uint32_t)j, got->value, want->value, ACCEL_CURVE_GAIN_MAX);
+            raw += abs(want->value);
+            accelerated += abs(got->value);
+        }
+
+        zassert_true(accelerated > raw, "%s: %u counts out for %u in, no acceleration",
+                     traces[i].name, accelerated, raw);
+    }
+}
+
+ZTEST(abs2rel_replay, test_prediction) {
+    for (size_t i = 0; i < ARRAY_SIZE(traces); i++) {
+        int32_t sum_x, sum_y;
+        uint32_t reported;
+        bool predicted = false;
+
+        model_build(&model, &traces[i], false);
+        replay(DEVICE_DT_GET(PREDICT_NODE), &traces[i]);
+        output_travel(&sum_x, &sum_y, &reported);
+
+        /* Forwarded events line up with the trace; the paybacks are reported on lift */
+        zassert_equal(result.count, model.count + reported, "%s: %u events out, expected %u",
+                      traces[i].name, (uint32_t)result.count, (uint32_t)model.count + reported);
+        for (size_t j = 0, k = 0; j < result.count; j++) {
+            const struct input_event *got = &result.out[j].event;
+
+            if (result.out[j].reported) {
+                continue;
+            }
+            predicted |= got->value != model.out[k].value;
+            zassert_true(got->type == model.out[k].type && got->code == model.out[k].code,
+                         "%s: event %u out of order", traces[i].name, (uint32_t)j);
+            k++;
+        }
+        zassert_true(predicted, "%s: output equals the raw deltas", traces[i].name);
+
+        /* The lead is paid back: no drift beyond the rounding carry of each touch */
+        zassert_true(abs(sum_x - model.travel_x) <= model.touches,
+                     "%s: REL_X total %d, expected %d", traces[i].name, sum_x, model.travel_x);
+        zassert_true(abs(sum_y - model.travel_y) <= model.touches,
+                     "%s: REL_Y total %d, expected %d", traces[i].name, sum_y, model.travel_y);
+    }
+}
+
+ZTEST_SUITE(abs2rel_replay, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/ztest.h>
+#include <drivers/input_processor.h>
+
+#include "trace_replay.h"
+
+#define TICKS_PER_SEC_HEADER "# ticks_per_sec="
+
+/* Replay in progress, written by the test thread and the report work queue */
+static struct k_spinlock capture_lock;
+static struct trace_result *capture;
+static const struct device *capture_dev;
+
+void trace_reader_init(struct trace_reader *reader, const char *csv, size_t len) {
+    reader->pos = csv;
+    reader->end = csv + len;
+    reader->ticks_per_sec = CONFIG_SYS_CLOCK_TICKS_PER_SEC;
+    reader->line = 0;
+}
+
+/**
+ * Parse a decimal integer followed by @p sep, or by the end of the line if @p sep is 0
+ */
+static bool parse_field(struct trace_reader *reader, int64_t *value, char sep) {
+    const bool negative = reader->pos < reader->end && *reader->pos == '-';
+    int64_t result = 0;
+    bool digits = false;
+
+    if (negative) {
+        reader->pos++;
+    }
+    while (reader->pos < reader->end && *reader->pos >= '0' && *reader->pos <= '9') {
+        result = result * 10 + (*reader->pos - '0');
+        digits = true;
+        reader->pos++;
+    }
+    if (!digits) {
+        return false;
+    }
+
+    if (sep != '\0') {
+        if (reader->pos == reader->end || *reader->pos != sep) {
+            return false;
+        }
+        reader->pos++;
+    } else if (reader->pos < reader->end && *reader->pos != '\r' && *reader->pos != '\n') {
+        return false;
+    }
+
+    *value = negative ? -result : result;
+    return true;
+}
+
+static void skip_line(struct trace_reader *reader) {
+    while (reader->pos < reader->end && *reader->pos != '\n') {
+        reader->pos++;
+    }
+    if (reader->pos < reader->end) {
+        reader->pos++;
+    }
+}
+
+int trace_reader_next(struct trace_reader *reader, struct input_event *event, uint32_t *ticks) {
+    while (reader->pos < reader->end) {
+        const size_t left = reader->end - reader->pos;
+        int64_t fields[5];
+
+        reader->line++;
+
+        if (*reader->pos == '\r' || *reader->pos == '\n') {
+            skip_line(reader);
+            continue;
+        }
+
+        if (*reader->pos == '#') {
+            const size_t header = sizeof(TICKS_PER_SEC_HEADER) - 1;
+
+            if (left > header && memcmp(reader->pos, TICKS_PER_SEC_HEADER, header) == 0) {
+                reader->pos += header;
+                if (!parse_field(reader, &fields[0], '\0') || fields[0] <= 0) {
+                    return -EINVAL;
+                }
+                reader->ticks_per_sec = fields[0];
+            }
+            skip_line(reader);
+            continue;
+        }
+
+        for (int i = 0; i < ARRAY_SIZE(fields); i++) {
+            if (!parse_field(reader, &fields[i], (i < ARRAY_SIZE(fields) - 1) ? ',' : '\0')) {
+                return -EINVAL;
+            }
+        }
+        skip_line(reader);
+
+        *ticks = fields[0];
+        *event = (struct input_event){
+            .dev = NULL,
+            .type = fields[1],
+            .code = fields[2],
+            .value = fields[3],
+            .sync = fields[4] != 0,
+        };
+        return 1;
+    }
+
+    return 0;
+}
+
+static void capture_append(const struct input_event *event, bool reported) {
+    k_spinlock_key_t key = k_spin_lock(&capture_lock);
+
+    if (capture != NULL) {
+        if (capture->count < ARRAY_SIZE(capture->out)) {
+            capture->out[capture->count++] = (struct trace_output){
+                .event = *event,
+                .uptime_ms = k_uptime_get(),
+                .ticks = capture->ticks,
+                .reported = reported,
+            };
+        } else {
+            capture->overflow = true;
+        }
+    }
+    k_spin_unlock(&capture_lock, key);
+}
+
+void trace_replay_capture(struct input_event *event, void *user_data) {
+    ARG_UNUSED(user_data);
+
+    if (event->dev == capture_dev) {
+        capture_append(event, true);
+    }
+}
+
+int trace_replay(const struct device *dev, const char *csv, size_t len,
+                 struct trace_result *result) {
+    const struct zmk_input_processor_driver_api *api = dev->api;
+    struct zmk_input_processor_state state = {0};
+    struct trace_reader reader;
+    struct input_event event;
+    uint32_t ticks, previous = 0;
+    int ret;
+
+    memset(result, 0, sizeof(*result));
+    trace_reader_init(&reader, csv, len);
+
+    k_spinlock_key_t key = k_spin_lock(&capture_lock);
+    capture = result;
+    capture_dev = dev;
+    k_spin_unlock(&capture_lock, key);
+
+    while ((ret = trace_reader_next(&reader, &event, &ticks)) > 0) {
+        /* Keep the recorded spacing so the report timers see the real timing */
+        if (result->events_in > 0) {
+            k_sleep(K_USEC((uint64_t)(uint32_t)(ticks - previous) * USEC_PER_SEC /
+                           reader.ticks_per_sec));
+        }
+        previous = ticks;
+
+        key = k_spin_lock(&capture_lock);
+        result->ticks = ticks;
+        result->ticks_per_sec = reader.ticks_per_sec;
+        k_spin_unlock(&capture_lock, key);
+
+        const uint32_t start = k_cycle_get_32();
+        ret = api->handle_event(dev, &event, 0, 0, &state);
+        result->cycles += k_cycle_get_32() - start;
+        result->events_in++;
+
+        if (ret < 0) {
+            break;
+        }
+        if (ret == ZMK_INPUT_PROC_CONTINUE) {
+            capture_append(&event, false);
+        }
+    }
+
+    if (ret < 0) {
+        TC_PRINT("Trace line %u: error %d\n", reader.line, ret);
+    } else {
+        k_sleep(K_MSEC(TRACE_REPLAY_SETTLE_MS));
+    }
+
+    key = k_spin_lock(&capture_lock);
+    capture = NULL;
+    capture_dev = NULL;
+    k_spin_unlock(&capture_lock, key);
+
+    return ret;
+}
+
+void trace_replay_report(const char *name, const struct trace_result *result) {
+    const uint32_t events = MAX(result->events_in, 1);
+    const uint32_t cycles_per_event = result->cycles / events;
+    const uint32_t events_per_sec =
+        (result->cycles > 0)
+            ? (uint64_t)result->events_in * sys_clock_hw_cycles_per_sec() / result->cycles
+            : 0;
+    const uint32_t ratio = result->count * 1000 / events;
+
+    TC_PRINT("%s: %u events in, %u out, output/input %u.%03u, %u cycles/event, "
+             "%u events/s\n",
+             name, result->events_in, (uint32_t)result->count, ratio / 1000, ratio % 1000,
+             cycles_per_event, events_per_sec);
+}
+
+void trace_replay_dump(const char *name, const struct trace_result *result) {
+    TC_PRINT("Output of %s:\n" TICKS_PER_SEC_HEADER "%u\n", name, result->ticks_per_sec);
+    for (size_t i = 0; i < result->count; i++) {
+        const struct trace_output *out = &result->out[i];
+
+        TC_PRINT("%u,%u,%u,%d,%u\n", out->ticks, out->event.type, out->event.code,
+                 out->event.value, out->event.sync);
+    }
+}
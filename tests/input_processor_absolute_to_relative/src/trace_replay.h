@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/device.h>
+#include <zephyr/input/input.h>
+
+/* Most events one replay captures */
+#define TRACE_OUTPUT_MAX 256
+
+/* Time left after the last event for the report timers to flush */
+#define TRACE_REPLAY_SETTLE_MS 100
+
+/**
+ * Reader over a CSV trace as written by zmk,input-processor-trace: one
+ * `ticks,type,code,value,sync` record per line, `#` comment lines, and an optional
+ * `# ticks_per_sec=N` header giving the tick rate of the timestamps.
+ */
+struct trace_reader {
+    const char *pos;
+    const char *end;
+    uint32_t ticks_per_sec;
+    uint32_t line;
+};
+
+/**
+ * Start reading @p len bytes of CSV; the buffer need not be NUL-terminated
+ */
+void trace_reader_init(struct trace_reader *reader, const char *csv, size_t len);
+
+/**
+ * Read the next record into @p event (dev NULL) and its timestamp into @p ticks.
+ * Returns 1 for a record, 0 at the end of the trace, -EINVAL for a malformed line.
+ */
+int trace_reader_next(struct trace_reader *reader, struct input_event *event, uint32_t *ticks);
+
+/* One event leaving the processor */
+struct trace_output {
+    struct input_event event;
+    int64_t uptime_ms;
+    uint32_t ticks; /* Recorded timestamp of the last event replayed before it */
+    bool reported;  /* Reported from the processor device, not forwarded by handle_event */
+};
+
+struct trace_result {
+    struct trace_output out[TRACE_OUTPUT_MAX];
+    size_t count;
+    bool overflow;
+    uint32_t events_in;
+    uint32_t ticks;         /* Recorded timestamp of the event being replayed */
+    uint32_t ticks_per_sec; /* Tick rate of the replayed trace */
+    uint64_t cycles;        /* Spent in handle_event */
+};
+
+/**
+ * Replay a trace through the handle_event of @p dev at the recorded pace and capture
+ * what leaves the processor into @p result, in order. Returns 0 or a negative errno.
+ */
+int trace_replay(const struct device *dev, const char *csv, size_t len,
+                 struct trace_result *result);
+
+/**
+ * Input callback capturing the events a processor device reports during a replay.
+ * Register it with INPUT_CALLBACK_DEFINE() for each replayed processor.
+ */
+void trace_replay_capture(struct input_event *event, void *user_data);
+
+/**
+ * Print events/s and cycles/event of handle_event and the output/input event ratio
+ */
+void trace_replay_report(const char *name, const struct trace_result *result);
+
+/**
+ * Print the captured output as a trace, stamped with the input timestamps. This is the
+ * format of the expected outputs, so a dump can replace one after an intended change.
+ */
+void trace_replay_dump(const char *name, const struct trace_result *result);